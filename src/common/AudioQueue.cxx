@@ -15,10 +15,14 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <thread>
+
 #include "AudioQueue.hxx"
 
-using std::mutex;
-using std::lock_guard;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_acq_rel;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
@@ -50,9 +54,7 @@ uInt32 AudioQueue::capacity() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::size() const
 {
-  lock_guard<mutex> guard(myMutex);
-
-  return mySize;
+  return distance(myReadIndex.load(memory_order_acquire), myWriteIndex.load(memory_order_acquire));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -70,8 +72,6 @@ uInt32 AudioQueue::fragmentSize() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::enqueue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   Int16* newFragment;
 
   if (!fragment) {
@@ -83,40 +83,79 @@ Int16* AudioQueue::enqueue(Int16* fragment)
     return newFragment;
   }
 
-  const uInt8 capacity = uInt8(myFragmentQueue.size());
-  const uInt8 fragmentIndex = (myNextFragment + mySize) % capacity;
+  const uInt32 writeIndex = myWriteIndex.load(memory_order_relaxed);
+  uInt32 readIndex = myReadIndex.load(memory_order_acquire);
+  uInt32 size = distance(readIndex, writeIndex);
+
+  if (size == capacity()) {
+    // The queue is full: claim the oldest fragment, unless the consumer takes
+    // it first. It occupies the slot of the new one and is handed back to be
+    // refilled.
+    if (myReadIndex.compare_exchange_strong(readIndex, nextIndex(readIndex), memory_order_acq_rel)) {
+      Int16*& slot = myFragmentQueue[writeIndex % capacity()];
+      newFragment = slot;
+      slot = fragment;
 
-  newFragment = myFragmentQueue.at(fragmentIndex);
-  myFragmentQueue.at(fragmentIndex) = fragment;
+      myWriteIndex.store(nextIndex(writeIndex), memory_order_release);
 
-  if (mySize < capacity) ++mySize;
-  else {
-    myNextFragment = (myNextFragment + 1) % capacity;
-    if (!myIgnoreOverflows) myOverflowLogger.log();
+      myOverflows.fetch_add(1, memory_order_relaxed);
+      if (!myIgnoreOverflows.load(memory_order_relaxed)) myOverflowLogger.log();
+
+      return newFragment;
+    }
+
+    size = distance(readIndex, writeIndex);
   }
 
+  // The fragment in the slot was claimed by the consumer, wait until it has
+  // swapped in the played fragment
+  const uInt32 claimedIndex = (writeIndex + capacity()) % (2 * capacity());
+  while (myDequeueIndex.load(memory_order_acquire) == claimedIndex)
+    std::this_thread::yield();
+
+  Int16*& slot = myFragmentQueue[writeIndex % capacity()];
+  newFragment = slot;
+  slot = fragment;
+
+  myWriteIndex.store(nextIndex(writeIndex), memory_order_release);
+
+  if (size + 1 > myPeakSize.load(memory_order_relaxed))
+    myPeakSize.store(size + 1, memory_order_relaxed);
+
   return newFragment;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::dequeue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
+  if (!fragment && !myFirstFragmentForDequeue) throw runtime_error("dequeue called empty");
 
-  if (mySize == 0) return nullptr;
+  // Claim the next fragment; this competes with the producer dropping it
+  uInt32 readIndex = myReadIndex.load(memory_order_acquire);
+  for (;;) {
+    if (readIndex == myWriteIndex.load(memory_order_acquire)) {
+      myDequeueIndex.store(NO_INDEX, memory_order_release);
+      myUnderruns.fetch_add(1, memory_order_relaxed);
 
-  if (!fragment) {
-    if (!myFirstFragmentForDequeue) throw runtime_error("dequeue called empty");
+      return nullptr;
+    }
 
+    myDequeueIndex.store(readIndex, memory_order_release);
+    if (myReadIndex.compare_exchange_weak(readIndex, nextIndex(readIndex), memory_order_acq_rel))
+      break;
+  }
+
+  if (!fragment) {
     fragment = myFirstFragmentForDequeue;
     myFirstFragmentForDequeue = nullptr;
   }
 
-  Int16* nextFragment = myFragmentQueue.at(myNextFragment);
-  myFragmentQueue.at(myNextFragment) = fragment;
+  Int16*& slot = myFragmentQueue[readIndex % capacity()];
+  Int16* nextFragment = slot;
+  slot = fragment;
 
-  --mySize;
-  myNextFragment = (myNextFragment + 1) % myFragmentQueue.size();
+  // Hands the slot (now holding the played fragment) back to the producer
+  myDequeueIndex.store(NO_INDEX, memory_order_release);
 
   return nextFragment;
 }
@@ -124,8 +163,6 @@ Int16* AudioQueue::dequeue(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::closeSink(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   if (myFirstFragmentForDequeue && fragment)
     throw runtime_error("attempt to return unknown buffer on closeSink");
 
@@ -136,5 +173,31 @@ void AudioQueue::closeSink(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::ignoreOverflows(bool shouldIgnoreOverflows)
 {
-  myIgnoreOverflows = shouldIgnoreOverflows;
+  myIgnoreOverflows.store(shouldIgnoreOverflows, memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioQueue::Statistics AudioQueue::statistics() const
+{
+  Statistics stats;
+
+  stats.size = size();
+  stats.capacity = capacity();
+  stats.peakSize = myPeakSize.load(memory_order_relaxed);
+  stats.overflows = myOverflows.load(memory_order_relaxed);
+  stats.underruns = myUnderruns.load(memory_order_relaxed);
+
+  return stats;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioQueue::nextIndex(uInt32 index) const
+{
+  return index + 1 < 2 * capacity() ? index + 1 : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioQueue::distance(uInt32 readIndex, uInt32 writeIndex) const
+{
+  return writeIndex >= readIndex ? writeIndex - readIndex : writeIndex + 2 * capacity() - readIndex;
 }
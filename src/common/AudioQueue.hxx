@@ -18,7 +18,7 @@
 #ifndef AUDIO_QUEUE_HXX
 #define AUDIO_QUEUE_HXX
 
-#include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "StaggeredLogger.hxx"
@@ -33,9 +33,24 @@
   The queue needs to be threadsafe as the (SDL) audio driver runs on a
   separate thread. Samples are stored as signed 16 bit integers
   (platform endian).
+
+  There must be exactly one producer (calling enqueue) and one consumer
+  (calling dequeue and closeSink). Neither side takes a lock, and the audio
+  thread never waits for the emulation. If the queue is full, the oldest
+  queued fragment is dropped and handed back to the producer for refilling.
 */
 class AudioQueue
 {
+  public:
+
+    struct Statistics {
+      uInt32 size{0};       // number of queued fragments
+      uInt32 capacity{0};
+      uInt32 peakSize{0};   // highest number of queued fragments
+      uInt32 overflows{0};  // old fragments dropped because the queue was full
+      uInt32 underruns{0};  // dequeues that found the queue empty
+    };
+
   public:
 
     /**
@@ -96,6 +111,25 @@ class AudioQueue
      */
     void ignoreOverflows(bool shouldIgnoreOverflows);
 
+    /**
+      Get the fill level statistics. These are updated without locking, so
+      the values may be slightly out of sync with each other.
+     */
+    Statistics statistics() const;
+
+  private:
+
+    /**
+      Advance a read/write index, which runs over twice the capacity in
+      order to distinguish a full from an empty queue.
+     */
+    uInt32 nextIndex(uInt32 index) const;
+
+    /**
+      The number of queued fragments between the given indices.
+     */
+    uInt32 distance(uInt32 readIndex, uInt32 writeIndex) const;
+
   private:
 
     // The size of an individual fragment (in stereo / mono samples)
@@ -104,7 +138,8 @@ class AudioQueue
     // Are we using stereo samples?
     bool myIsStereo{false};
 
-    // The fragment queue
+    // The fragment queue. Each slot holds a fragment, all slots between the
+    // read and the write index hold queued ones.
     vector<Int16*> myFragmentQueue;
 
     // All fragments, including the two fragments that are in circulation.
@@ -113,14 +148,21 @@ class AudioQueue
     // We allocate a consecutive slice of memory for the fragments.
     unique_ptr<Int16[]> myFragmentBuffer;
 
-    // The nubmer if queued fragments
-    uInt32 mySize{0};
+    // The next fragment to dequeue (advanced by the consumer, and by the
+    // producer when it drops the oldest fragment)
+    std::atomic<uInt32> myReadIndex{0};
+
+    // The fragment the consumer is claiming or swapping, or NO_INDEX
+    static constexpr uInt32 NO_INDEX = ~0U;
+    std::atomic<uInt32> myDequeueIndex{NO_INDEX};
 
-    // The next fragment.
-    uInt32 myNextFragment{0};
+    // The next fragment to enqueue (written by the producer only)
+    std::atomic<uInt32> myWriteIndex{0};
 
-    // We need a mutex for thread safety.
-    mutable std::mutex myMutex;
+    // Statistics
+    std::atomic<uInt32> myPeakSize{0};
+    std::atomic<uInt32> myOverflows{0};
+    std::atomic<uInt32> myUnderruns{0};
 
     // The first (empty) enqueue call returns this fragment.
     Int16* myFirstFragmentForEnqueue{nullptr};
@@ -128,7 +170,7 @@ class AudioQueue
     Int16* myFirstFragmentForDequeue{nullptr};
 
     // Log overflows?
-    bool myIgnoreOverflows{true};
+    std::atomic<bool> myIgnoreOverflows{true};
 
     StaggeredLogger myOverflowLogger{"audio buffer overflow", Logger::Level::INFO};
 
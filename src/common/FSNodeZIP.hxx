@@ -52,6 +52,10 @@ class FilesystemNodeZIP : public AbstractFSNode
     bool isFile() const      override { return _isFile;      }
     bool isReadable() const  override { return _realNode && _realNode->isReadable(); }
     bool isWritable() const  override { return false; }
+    bool getFileInfo(uInt64& size, uInt64& time) const override {
+      // Any change of a file changes the archive
+      return _realNode && _realNode->getFileInfo(size, time);
+    }
 
     //////////////////////////////////////////////////////////
     // For now, ZIP files cannot be modified in any way
@@ -131,6 +131,11 @@ class LinkedObjectPool
     */
     const_iter first() const { return myList.begin(); }
 
+    /**
+      Return an iterator to the 'current' node in the active list.
+    */
+    const_iter currentIter() const { return myCurrent; }
+
     /**
       Return an iterator to the last node in the active list.
     */
@@ -246,6 +251,14 @@ class LinkedObjectPool
       }
     }
 
+    /**
+      Increase the capacity of the pool, keeping the active list.
+    */
+    void grow(uInt32 capacity) {
+      for(; myCapacity < capacity; ++myCapacity)
+        myPool.emplace_back(T());
+    }
+
     /**
       Erase entire contents of active list.
     */
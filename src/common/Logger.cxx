@@ -51,15 +51,17 @@ void Logger::debug(const string& message)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::logMessage(const string& message, Level level)
 {
+  std::lock_guard<std::mutex> lock(myMutex);
+
   if(level == Logger::Level::ERR)
   {
-    cout << message << endl << std::flush;
+    *myConsole << message << endl << std::flush;
     myLogMessages += message + "\n";
   }
   else if(static_cast<int>(level) <= myLogLevel)
   {
     if(myLogToConsole)
-      cout << message << endl << std::flush;
+      *myConsole << message << endl << std::flush;
     myLogMessages += message + "\n";
   }
 }
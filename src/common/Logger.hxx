@@ -19,6 +19,7 @@
 #define LOGGER_HXX
 
 #include <functional>
+#include <mutex>
 
 #include "bspf.hxx"
 
@@ -49,6 +50,9 @@ class Logger {
     void setLogParameters(int logLevel, bool logToConsole);
     void setLogParameters(Level logLevel, bool logToConsole);
 
+    // Redirect console output, e.g. to keep it apart from results on cout
+    void setConsoleStream(ostream& stream) { myConsole = &stream; }
+
     const string& logMessages() const { return myLogMessages; }
 
   protected:
@@ -57,10 +61,14 @@ class Logger {
   private:
     int myLogLevel{static_cast<int>(Level::MAX)};
     bool myLogToConsole{true};
+    ostream* myConsole{&cout};
 
     // The list of log messages
     string myLogMessages;
 
+    // Log messages may arrive from several emulation threads (e.g. batch runs)
+    std::mutex myMutex;
+
   private:
     void logMessage(const string& message, Level level);
 
@@ -37,6 +37,20 @@ PNGLibrary::PNGLibrary(OSystem& osystem)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGLibrary::~PNGLibrary()
+{
+  // The encoder saves all queued snapshots before quitting
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myQueueChanged.notify_all();
+
+  if(myEncoder.joinable())
+    myEncoder.join();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
 {
@@ -129,6 +143,21 @@ void PNGLibrary::saveImage(const string& filename, const VariantList& comments)
   if(!out.is_open())
     throw runtime_error("ERROR: Couldn't create snapshot file");
 
+  Snapshot snapshot;
+  readFrameBuffer(snapshot);
+
+  // Set up pointers into "buffer" byte array
+  vector<png_bytep> rows(snapshot.height);
+  for(png_uint_32 k = 0; k < snapshot.height; ++k)
+    rows[k] = static_cast<png_bytep>(snapshot.pixels.data() + k*snapshot.width*4);
+
+  // And save the image
+  saveImageToDisk(out, rows, snapshot.width, snapshot.height, comments);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::readFrameBuffer(Snapshot& snapshot)
+{
   const FrameBuffer& fb = myOSystem.frameBuffer();
 
   const Common::Rect& rectUnscaled = fb.imageRect();
@@ -137,19 +166,12 @@ void PNGLibrary::saveImage(const string& filename, const VariantList& comments)
     fb.scaleX(rectUnscaled.w()), fb.scaleY(rectUnscaled.h())
   );
 
-  png_uint_32 width = rect.w(), height = rect.h();
+  snapshot.width = rect.w();
+  snapshot.height = rect.h();
 
   // Get framebuffer pixel data (we get ABGR format)
-  vector<png_byte> buffer(width * height * 4);
-  fb.readPixels(buffer.data(), width*4, rect);
-
-  // Set up pointers into "buffer" byte array
-  vector<png_bytep> rows(height);
-  for(png_uint_32 k = 0; k < height; ++k)
-    rows[k] = static_cast<png_bytep>(buffer.data() + k*width*4);
-
-  // And save the image
-  saveImageToDisk(out, rows, width, height, comments);
+  snapshot.pixels.resize(snapshot.width * snapshot.height * 4);
+  fb.readPixels(snapshot.pixels.data(), snapshot.width*4, rect);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -183,7 +205,8 @@ void PNGLibrary::saveImage(const string& filename, const FBSurface& surface,
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::saveImageToDisk(std::ofstream& out, const vector<png_bytep>& rows,
-    png_uint_32 width, png_uint_32 height, const VariantList& comments)
+    png_uint_32 width, png_uint_32 height, const VariantList& comments,
+    int compression)
 {
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
@@ -208,6 +231,7 @@ void PNGLibrary::saveImageToDisk(std::ofstream& out, const vector<png_bytep>& ro
 
   // Set up the output control
   png_set_write_fn(png_ptr, &out, png_write_data, png_io_flush);
+  png_set_compression_level(png_ptr, compression);
 
   // Write PNG header info
   png_set_IHDR(png_ptr, info_ptr, width, height, 8,
@@ -269,13 +293,26 @@ void PNGLibrary::toggleContinuousSnapshots(bool perFrame)
     }
     myOSystem.frameBuffer().showTextMessage(buf.str());
     setContinuousSnapInterval(interval);
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    myDropped = myContinuousFailed = 0;
   }
   else
   {
     ostringstream buf;
-    buf << "Disabling snapshots, generated "
-      << (mySnapCounter / mySnapInterval)
-      << " files";
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      // Snapshots still queued from an earlier run may fail in this one
+      const uInt32 taken = mySnapCounter / mySnapInterval,
+                   lost = myDropped + myContinuousFailed;
+      buf << "Disabling snapshots, generated "
+          << (taken > lost ? taken - lost : 0) << " files";
+      if(myDropped > 0)
+        buf << ", dropped " << myDropped;
+      if(myContinuousFailed > 0)
+        buf << ", " << myContinuousFailed << " failed";
+    }
     myOSystem.frameBuffer().showTextMessage(buf.str());
     setContinuousSnapInterval(0);
   }
@@ -312,22 +349,22 @@ void PNGLibrary::takeSnapshot(uInt32 number)
   else if(!myOSystem.settings().getBool("sssingle"))
   {
     // Determine if the file already exists, checking each successive filename
-    // until one doesn't exist
-    filename = sspath + ".png";
-    FilesystemNode node(filename);
-    if(node.exists())
+    // until one doesn't exist; names already used are skipped, since their
+    // snapshots may not have been written yet
+    uInt32 i = sspath == mySnapPath ? mySnapIndex + 1 : 0;
+    for(; ; ++i)
     {
       ostringstream buf;
-      for(uInt32 i = 1; ;++i)
-      {
-        buf.str("");
-        buf << sspath << "_" << i << ".png";
-        FilesystemNode next(buf.str());
-        if(!next.exists())
-          break;
-      }
+      buf << sspath;
+      if(i > 0)
+        buf << "_" << i;
+      buf << ".png";
       filename = buf.str();
+      if(!FilesystemNode(filename).exists())
+        break;
     }
+    mySnapPath = sspath;
+    mySnapIndex = i;
   }
   else
     filename = sspath + ".png";
@@ -345,20 +382,38 @@ void PNGLibrary::takeSnapshot(uInt32 number)
   VarList::push_back(comments, "ROM MD5", myOSystem.console().properties().get(PropType::Cart_MD5));
   VarList::push_back(comments, "TV Effects", myOSystem.frameBuffer().tiaSurface().effectsInfo());
 
-  // Now create a PNG snapshot
-  string message = "Snapshot saved";
-  if(myOSystem.settings().getBool("ss1x"))
+  // Now capture the image, reusing the buffer of an earlier snapshot
+  Snapshot snapshot;
+  snapshot.filename = filename;
+  snapshot.comments = std::move(comments);
+  snapshot.compression = myOSystem.settings().getInt("sscompression");
+  snapshot.continuous = number > 0;
   {
-    try
+    std::lock_guard<std::mutex> lock(myMutex);
+    if(!myFreeBuffers.empty())
     {
-      Common::Rect rect;
-      const FBSurface& surface = myOSystem.frameBuffer().tiaSurface().baseSurface(rect);
-      myOSystem.png().saveImage(filename, surface, rect, comments);
+      snapshot.pixels = std::move(myFreeBuffers.back());
+      myFreeBuffers.pop_back();
     }
-    catch(const runtime_error& e)
+  }
+
+  if(myOSystem.settings().getBool("ss1x"))
+  {
+    Common::Rect rect;
+    const FBSurface& surface = myOSystem.frameBuffer().tiaSurface().baseSurface(rect);
+
+    // Do we want the entire surface or just a section?
+    snapshot.width = rect.w();
+    snapshot.height = rect.h();
+    if(rect.empty())
     {
-      message = e.what();
+      snapshot.width = surface.width();
+      snapshot.height = surface.height();
     }
+
+    // Get the surface pixel data (we get ABGR format)
+    snapshot.pixels.resize(snapshot.width * snapshot.height * 4);
+    surface.readPixels(snapshot.pixels.data(), snapshot.width, rect);
   }
   else
   {
@@ -366,19 +421,106 @@ void PNGLibrary::takeSnapshot(uInt32 number)
     myOSystem.frameBuffer().enableMessages(false);
     myOSystem.frameBuffer().tiaSurface().renderForSnapshot();
 
+    readFrameBuffer(snapshot);
+
+    // Re-enable old messages
+    myOSystem.frameBuffer().enableMessages(true);
+  }
+
+  // Single snapshots wait until they are saved, continuous snapshots are
+  // dropped if the encoder cannot keep up
+  const bool wait = number == 0;
+  string message;
+  if(queueSnapshot(std::move(snapshot), wait, message))
+    message = wait ? "Snapshot saved" : "Snapshot taken";
+  else if(!wait)
+    message = "Snapshot dropped";
+  myOSystem.frameBuffer().showTextMessage(message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PNGLibrary::queueSnapshot(Snapshot&& snapshot, bool wait, string& error)
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  if(!myEncoder.joinable())
+    myEncoder = std::thread([this]() { encodeSnapshots(); });
+
+  if(myQueue.size() >= MAX_QUEUED_SNAPSHOTS)
+  {
+    if(!wait)
+    {
+      ++myDropped;
+      myFreeBuffers.push_back(std::move(snapshot.pixels));
+      return false;
+    }
+    myQueueChanged.wait(lock, [this]() { return myQueue.size() < MAX_QUEUED_SNAPSHOTS; });
+  }
+
+  // Only the result of this image counts, not that of others saved before
+  std::promise<string> result;
+  std::future<string> saved;
+  if(wait)
+  {
+    snapshot.result = &result;
+    saved = result.get_future();
+  }
+
+  myQueue.push_back(std::move(snapshot));
+  myQueueChanged.notify_all();
+
+  if(wait)
+  {
+    lock.unlock();
+    error = saved.get();
+    return error.empty();
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::encodeSnapshots()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myQueueChanged.wait(lock, [this]() { return myQuit || !myQueue.empty(); });
+    if(myQueue.empty())
+      break;
+
+    Snapshot snapshot = std::move(myQueue.front());
+    myQueue.pop_front();
+    myQueueChanged.notify_all();
+    lock.unlock();
+
+    string error;
     try
     {
-      myOSystem.png().saveImage(filename, comments);
+      std::ofstream out(snapshot.filename, std::ios_base::binary);
+      if(!out.is_open())
+        throw runtime_error("ERROR: Couldn't create snapshot file");
+
+      // Set up pointers into "buffer" byte array
+      vector<png_bytep> rows(snapshot.height);
+      for(png_uint_32 k = 0; k < snapshot.height; ++k)
+        rows[k] = static_cast<png_bytep>(snapshot.pixels.data() + k*snapshot.width*4);
+
+      saveImageToDisk(out, rows, snapshot.width, snapshot.height,
+                      snapshot.comments, snapshot.compression);
     }
     catch(const runtime_error& e)
     {
-      message = e.what();
+      error = e.what();
     }
 
-    // Re-enable old messages
-    myOSystem.frameBuffer().enableMessages(true);
+    lock.lock();
+    if(!error.empty() && snapshot.continuous)
+      ++myContinuousFailed;
+    if(snapshot.result)
+      snapshot.result->set_value(error);
+    myFreeBuffers.push_back(std::move(snapshot.pixels));
   }
-  myOSystem.frameBuffer().showTextMessage(message);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
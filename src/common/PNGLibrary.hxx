@@ -21,6 +21,11 @@
 #define PNGLIBRARY_HXX
 
 #include <png.h>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
 
 class OSystem;
 class FrameBuffer;
@@ -34,12 +39,17 @@ class Properties;
   abstracts all the irrelevant details other loading and saving an
   actual image.
 
+  Snapshots are compressed and written by a background thread, so that
+  continuous snapshots don't slow down emulation.  Captured images wait in
+  a bounded queue; continuous snapshots are dropped while it is full.
+
   @author  Stephen Anthony
 */
 class PNGLibrary
 {
   public:
     explicit PNGLibrary(OSystem& osystem);
+    ~PNGLibrary();
 
     /**
       Read a PNG image from the specified file into a FBSurface structure,
@@ -134,6 +144,36 @@ class PNGLibrary
     uInt32 mySnapInterval{0};
     uInt32 mySnapCounter{0};
 
+    // The last snapshot name probed for in the filesystem, and its number
+    string mySnapPath;
+    uInt32 mySnapIndex{0};
+
+    // A captured image, waiting to be saved
+    struct Snapshot {
+      string filename;
+      vector<png_byte> pixels;  // ABGR format
+      png_uint_32 width{0}, height{0};
+      VariantList comments;
+      int compression{0};
+      bool continuous{false};
+      // Receives the error message (empty if saved) when waited for
+      std::promise<string>* result{nullptr};
+    };
+
+    // Maximum number of images waiting to be saved
+    static constexpr size_t MAX_QUEUED_SNAPSHOTS = 8;
+
+    // Shared with the encoder thread, protected by 'myMutex'
+    std::deque<Snapshot> myQueue;
+    vector<vector<png_byte>> myFreeBuffers;  // reused for capturing
+    bool myQuit{false};
+    // Continuous snapshots which were dropped or could not be saved
+    uInt32 myDropped{0}, myContinuousFailed{0};
+
+    std::thread myEncoder;
+    std::mutex myMutex;
+    std::condition_variable myQueueChanged;
+
     // The following data remains between invocations of allocateStorage,
     // and is only changed when absolutely necessary.
     struct ReadInfoType {
@@ -157,6 +197,28 @@ class PNGLibrary
     */
     bool allocateStorage(png_uint_32 iwidth, png_uint_32 iheight);
 
+    /**
+      Read the current FrameBuffer image into the given snapshot.
+    */
+    void readFrameBuffer(Snapshot& snapshot);
+
+    /**
+      Queue a snapshot for the encoder thread.
+
+      @param snapshot  The captured image
+      @param wait      Wait until the queue has room (and the image has been
+                       saved), instead of dropping it if the queue is full
+      @param error     Receives the reason why a waited for image could not
+                       be saved
+      @return  False if the image was dropped or could not be saved
+    */
+    bool queueSnapshot(Snapshot&& snapshot, bool wait, string& error);
+
+    /**
+      The encoder thread, saves the queued images.
+    */
+    void encodeSnapshots();
+
     /** The actual method which saves a PNG image.
 
       @param out      The output stream for writing PNG data
@@ -164,10 +226,12 @@ class PNGLibrary
       @param width    The width of the PNG image
       @param height   The height of the PNG image
       @param comments The text comments to add to the PNG image
+      @param compression The zlib compression level
     */
     void saveImageToDisk(std::ofstream& out, const vector<png_bytep>& rows,
                          png_uint_32 width, png_uint_32 height,
-                         const VariantList& comments);
+                         const VariantList& comments,
+                         int compression = PNG_Z_DEFAULT_COMPRESSION);
 
     /**
       Load the PNG data from 'ReadInfo' into the FBSurface.  The surface
@@ -27,23 +27,16 @@ bool PhosphorHandler::initialize(bool enable, int blend)
   if(blend >= 0 && blend <= 100)
     myPhosphorPercent = blend / 100.F;
 
-  // Used to calculate an averaged color for the 'phosphor' effect
-  auto getPhosphor = [&] (const uInt8 c1, uInt8 c2) -> uInt8 {
-    // Use maximum of current and decayed previous values
-    c2 = static_cast<uInt8>(c2 * myPhosphorPercent);
-    if(c1 > c2)  return c1; // raise (assumed immediate)
-    else         return c2; // decay
-  };
-
-  // Precalculate the average colors for the 'phosphor' effect
+  // Precalculate the decayed colors for the 'phosphor' effect
   if(myUsePhosphor)
   {
-    for(int c = 255; c >= 0; --c)
-      for(int p = 255; p >= 0; --p)
-        ourPhosphorLUT[c][p] = getPhosphor(uInt8(c), uInt8(p));
+    ourDecay = myPhosphorPercent;
+    for(int p = 255; p >= 0; --p)
+      ourDecayLUT[p] = static_cast<uInt8>(p * ourDecay);
   }
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-PhosphorHandler::PhosphorLUT PhosphorHandler::ourPhosphorLUT;
+PhosphorHandler::DecayLUT PhosphorHandler::ourDecayLUT;
+float PhosphorHandler::ourDecay = 0.60F;
@@ -48,10 +48,17 @@ class PhosphorHandler
                   gp = static_cast<uInt8>(p >> 8),
                   bp = static_cast<uInt8>(p);
 
-      return (ourPhosphorLUT[rc][rp] << 16) | (ourPhosphorLUT[gc][gp] << 8) |
-              ourPhosphorLUT[bc][bp];
+      return (std::max(rc, ourDecayLUT[rp]) << 16) |
+             (std::max(gc, ourDecayLUT[gp]) << 8) |
+              std::max(bc, ourDecayLUT[bp]);
     }
 
+    /**
+      The factor the previous frame's colors decay with (see getPixel), for
+      use with RenderKernels::blendPhosphor.
+    */
+    static float decay() { return ourDecay; }
+
   private:
     // Use phosphor effect
     bool myUsePhosphor{false};
@@ -59,9 +66,11 @@ class PhosphorHandler
     // Amount to blend when using phosphor effect
     float myPhosphorPercent{0.60F};
 
-    // Precalculated averaged phosphor colors
-    using PhosphorLUT = BSPF::array2D<uInt8, kColor, kColor>;
-    static PhosphorLUT ourPhosphorLUT;
+    // Precalculated decayed color channels; the new value of a channel is
+    // the maximum of its current and its decayed previous value
+    using DecayLUT = std::array<uInt8, kColor>;
+    static DecayLUT ourDecayLUT;
+    static float ourDecay;
 
   private:
     PhosphorHandler(const PhosphorHandler&) = delete;
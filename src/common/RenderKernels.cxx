@@ -0,0 +1,265 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "RenderKernels.hxx"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define RENDER_KERNELS_SSE2
+  #include <emmintrin.h>
+#endif
+
+// AVX2 is only compiled in when the compiler can target it per function,
+// and used only if the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define RENDER_KERNELS_AVX2
+  #include <immintrin.h>
+  #define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+  // Only the RGB channels are kept when blending
+  constexpr uInt32 RGB_MASK = 0x00FFFFFF;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  inline uInt8 decayChannel(uInt8 p, float decay)
+  {
+    return static_cast<uInt8>(p * decay);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  inline uInt32 phosphorPixel(uInt32 c, uInt32 p, float decay)
+  {
+    const uInt8 r = std::max(static_cast<uInt8>(c >> 16), decayChannel(static_cast<uInt8>(p >> 16), decay)),
+                g = std::max(static_cast<uInt8>(c >> 8),  decayChannel(static_cast<uInt8>(p >> 8), decay)),
+                b = std::max(static_cast<uInt8>(c),       decayChannel(static_cast<uInt8>(p), decay));
+
+    return (r << 16) | (g << 8) | b;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  inline uInt32 averagePixel(uInt32 a, uInt32 b)
+  {
+    // Per channel (a + b) / 2, without carries between the channels
+    return ((a & b) + (((a ^ b) >> 1) & 0x7F7F7F7F)) & RGB_MASK;
+  }
+
+#ifdef RENDER_KERNELS_SSE2
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  inline __m128i decay4(__m128i v, __m128 decay)
+  {
+    return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(v), decay));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  uInt32 blendPhosphorSSE2(const uInt32* in, uInt32* prev, uInt32* out,
+                           uInt32 count, float decay)
+  {
+    const __m128 vdecay = _mm_set1_ps(decay);
+    const __m128i zero = _mm_setzero_si128(),
+                  mask = _mm_set1_epi32(RGB_MASK);
+    uInt32 i = 0;
+
+    for(; i + 4 <= count; i += 4)
+    {
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)),
+                    p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+
+      // Decay the previous channels in single precision, exactly like the
+      // scalar version does
+      const __m128i lo = _mm_unpacklo_epi8(p, zero),
+                    hi = _mm_unpackhi_epi8(p, zero);
+      const __m128i d = _mm_packus_epi16(
+        _mm_packs_epi32(decay4(_mm_unpacklo_epi16(lo, zero), vdecay),
+                        decay4(_mm_unpackhi_epi16(lo, zero), vdecay)),
+        _mm_packs_epi32(decay4(_mm_unpacklo_epi16(hi, zero), vdecay),
+                        decay4(_mm_unpackhi_epi16(hi, zero), vdecay)));
+
+      const __m128i r = _mm_and_si128(_mm_max_epu8(c, d), mask);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(prev + i), r);
+      if(out)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), r);
+    }
+    return i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  uInt32 averagePixelsSSE2(const uInt32* a, const uInt32* b, uInt32* out,
+                           uInt32 count)
+  {
+    const __m128i low7 = _mm_set1_epi8(0x7F),
+                  mask = _mm_set1_epi32(RGB_MASK);
+    uInt32 i = 0;
+
+    for(; i + 4 <= count; i += 4)
+    {
+      const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                    vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      const __m128i half = _mm_and_si128(_mm_srli_epi16(_mm_xor_si128(va, vb), 1), low7);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+        _mm_and_si128(_mm_add_epi8(_mm_and_si128(va, vb), half), mask));
+    }
+    return i;
+  }
+#endif
+
+#ifdef RENDER_KERNELS_AVX2
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  bool hasAVX2()
+  {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    return avx2;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  AVX2_TARGET uInt32 expandPaletteAVX2(const uInt8* in, uInt32* out, uInt32 count,
+                                       const PaletteArray& palette)
+  {
+    const int* base = reinterpret_cast<const int*>(palette.data());
+    uInt32 i = 0;
+
+    for(; i + 8 <= count; i += 8)
+    {
+      const __m256i index = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+        _mm256_i32gather_epi32(base, index, 4));
+    }
+    return i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  AVX2_TARGET inline __m256i decay8(__m256i v, __m256 decay)
+  {
+    return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(v), decay));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  AVX2_TARGET uInt32 blendPhosphorAVX2(const uInt32* in, uInt32* prev, uInt32* out,
+                                       uInt32 count, float decay)
+  {
+    const __m256 vdecay = _mm256_set1_ps(decay);
+    const __m256i zero = _mm256_setzero_si256(),
+                  mask = _mm256_set1_epi32(RGB_MASK);
+    uInt32 i = 0;
+
+    for(; i + 8 <= count; i += 8)
+    {
+      const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)),
+                    p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + i));
+
+      // Unpacking and packing both work per 128 bit lane, so the pixel
+      // order is preserved
+      const __m256i lo = _mm256_unpacklo_epi8(p, zero),
+                    hi = _mm256_unpackhi_epi8(p, zero);
+      const __m256i d = _mm256_packus_epi16(
+        _mm256_packs_epi32(decay8(_mm256_unpacklo_epi16(lo, zero), vdecay),
+                           decay8(_mm256_unpackhi_epi16(lo, zero), vdecay)),
+        _mm256_packs_epi32(decay8(_mm256_unpacklo_epi16(hi, zero), vdecay),
+                           decay8(_mm256_unpackhi_epi16(hi, zero), vdecay)));
+
+      const __m256i r = _mm256_and_si256(_mm256_max_epu8(c, d), mask);
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev + i), r);
+      if(out)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+    }
+    return i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  AVX2_TARGET uInt32 averagePixelsAVX2(const uInt32* a, const uInt32* b, uInt32* out,
+                                       uInt32 count)
+  {
+    const __m256i low7 = _mm256_set1_epi8(0x7F),
+                  mask = _mm256_set1_epi32(RGB_MASK);
+    uInt32 i = 0;
+
+    for(; i + 8 <= count; i += 8)
+    {
+      const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                    vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      const __m256i half = _mm256_and_si256(_mm256_srli_epi16(_mm256_xor_si256(va, vb), 1), low7);
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+        _mm256_and_si256(_mm256_add_epi8(_mm256_and_si256(va, vb), half), mask));
+    }
+    return i;
+  }
+#endif
+
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RenderKernels::expandPalette(const uInt8* in, uInt32* out, uInt32 count,
+                                  const PaletteArray& palette)
+{
+  uInt32 i = 0;
+
+#ifdef RENDER_KERNELS_AVX2
+  if(hasAVX2())
+    i = expandPaletteAVX2(in, out, count, palette);
+#endif
+
+  // Without a gather instruction, a plain loop is as fast as it gets
+  for(; i < count; ++i)
+    out[i] = palette[in[i]];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RenderKernels::blendPhosphor(const uInt32* in, uInt32* prev, uInt32* out,
+                                  uInt32 count, float decay)
+{
+  uInt32 i = 0;
+
+#if defined(RENDER_KERNELS_AVX2)
+  if(hasAVX2())
+    i = blendPhosphorAVX2(in, prev, out, count, decay);
+#endif
+#if defined(RENDER_KERNELS_SSE2)
+  i += blendPhosphorSSE2(in + i, prev + i, out ? out + i : nullptr, count - i, decay);
+#endif
+
+  for(; i < count; ++i)
+  {
+    prev[i] = phosphorPixel(in[i], prev[i], decay);
+    if(out)
+      out[i] = prev[i];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RenderKernels::averagePixels(const uInt32* a, const uInt32* b, uInt32* out,
+                                  uInt32 count)
+{
+  uInt32 i = 0;
+
+#if defined(RENDER_KERNELS_AVX2)
+  if(hasAVX2())
+    i = averagePixelsAVX2(a, b, out, count);
+#endif
+#if defined(RENDER_KERNELS_SSE2)
+  i += averagePixelsSSE2(a + i, b + i, out + i, count - i);
+#endif
+
+  for(; i < count; ++i)
+    out[i] = averagePixel(a[i], b[i]);
+}
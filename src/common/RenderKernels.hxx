@@ -0,0 +1,58 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef RENDER_KERNELS_HXX
+#define RENDER_KERNELS_HXX
+
+#include "FrameBufferConstants.hxx"
+#include "bspf.hxx"
+
+/**
+  Row kernels for converting and blending TIA frames.
+
+  On x86 the kernels use SSE2 or AVX2, selected at runtime depending on the
+  CPU; everywhere else a scalar version is used.  All versions produce
+  identical results.
+
+  @author  Stella Team
+*/
+namespace RenderKernels {
+
+  /**
+    Expand 'count' indexed TIA pixels into RGB colors using the given palette.
+  */
+  void expandPalette(const uInt8* in, uInt32* out, uInt32 count,
+                     const PaletteArray& palette);
+
+  /**
+    Apply the phosphor effect to 'count' pixels: each channel of 'prev'
+    becomes the maximum of the current value and the previous value
+    decayed by 'decay' (see PhosphorHandler::getPixel).  The result is
+    also written to 'out', unless it is null.
+  */
+  void blendPhosphor(const uInt32* in, uInt32* prev, uInt32* out, uInt32 count,
+                     float decay);
+
+  /**
+    Average the channels of 'count' pixels of two buffers (50:50, rounded
+    down), as used for snapshots in phosphor mode.
+  */
+  void averagePixels(const uInt32* a, const uInt32* b, uInt32* out, uInt32 count);
+
+} // namespace RenderKernels
+
+#endif
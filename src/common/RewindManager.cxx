@@ -26,6 +26,103 @@
 
 #include "RewindManager.hxx"
 
+namespace {
+  // Minimum number of unchanged bytes which end a run of changed bytes
+  constexpr uInt32 MIN_UNCHANGED_RUN = 4;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  void putVarInt(ByteArray& out, uInt32 value)
+  {
+    while(value >= 0x80)
+    {
+      out.push_back(uInt8(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(uInt8(value));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  uInt32 getVarInt(const ByteArray& in, size_t& pos)
+  {
+    uInt32 value = 0;
+
+    for(uInt32 shift = 0; pos < in.size(); shift += 7)
+    {
+      const uInt8 b = in[pos++];
+      value |= uInt32(b & 0x7f) << shift;
+      if(!(b & 0x80))
+        break;
+    }
+    return value;
+  }
+
+  /**
+    Encode 'data' as the XOR difference to 'base' (which is considered to
+    be zero-padded), as a sequence of (unchanged run, changed run, changed
+    bytes).  An empty base produces a keyframe with its zero runs skipped.
+  */
+  void encodeDelta(const ByteArray& data, const ByteArray& base, ByteArray& out)
+  {
+    const uInt32 size = uInt32(data.size());
+    const auto diff = [&](uInt32 i) -> uInt8 {
+      return data[i] ^ (i < base.size() ? base[i] : 0);
+    };
+
+    out.clear();
+    for(uInt32 i = 0; i < size; )
+    {
+      uInt32 unchanged = 0;
+      while(i + unchanged < size && diff(i + unchanged) == 0)
+        ++unchanged;
+      i += unchanged;
+
+      // Changed bytes, until enough unchanged ones follow
+      uInt32 end = i;
+      while(end < size)
+      {
+        if(diff(end) != 0)
+        {
+          ++end;
+          continue;
+        }
+        uInt32 run = 1;
+        while(end + run < size && run < MIN_UNCHANGED_RUN && diff(end + run) == 0)
+          ++run;
+        if(run >= MIN_UNCHANGED_RUN || end + run == size)
+          break;
+        end += run;
+      }
+
+      putVarInt(out, unchanged);
+      putVarInt(out, end - i);
+      for(; i < end; ++i)
+        out.push_back(diff(i));
+    }
+  }
+
+  /**
+    Apply a difference created by encodeDelta to 'data' (in place), which
+    then has the given size.
+  */
+  void decodeDelta(const ByteArray& delta, uInt32 size, ByteArray& data)
+  {
+    data.resize(size);
+
+    size_t pos = 0;
+    for(uInt32 i = 0; pos < delta.size(); )
+    {
+      i += getVarInt(delta, pos);
+      const uInt32 changed = getVarInt(delta, pos);
+
+      if(i + changed > size || pos + changed > delta.size())
+        throw runtime_error("corrupt rewind state");
+
+      for(uInt32 end = i + changed; i < end; ++i)
+        data[i] ^= delta[pos++];
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem{system},
@@ -45,7 +142,12 @@ void RewindManager::setup()
   //        Use those bounds in DeveloperDialog too
   mySize = std::min<uInt32>(
       myOSystem.settings().getInt(prefix + "tm.size"), MAX_BUF_SIZE);
-  if(mySize != myStateList.capacity())
+  myMemoryBudget = size_t(std::max(myOSystem.settings().getInt(prefix + "tm.memory"), 0))
+      * 1024 * 1024;
+
+  // A list grown within the memory budget is kept
+  if(mySize > myStateList.capacity() ||
+     (mySize < myStateList.capacity() && myMemoryBudget == 0))
     resize(mySize);
 
   myUncompressed = std::min<uInt32>(
@@ -119,29 +221,58 @@ bool RewindManager::addState(const string& message, bool timeMachine)
   }
 
   // Remove all future states
+  if(myStateList.currentIsValid() && !atLast())
+  {
+    for(auto it = myStateList.next(myStateList.currentIter()); it != myStateList.cend(); ++it)
+      releaseState(stateAt(it));
+    myLastDataValid = false;
+  }
   myStateList.removeToLast();
 
-  // Make sure we never run out of space
-  if(myStateList.full())
-    compressStates();
-
-  // Add new state at the end of the list (queue adds at end)
-  // This updates the 'current' iterator inside the list
-  myStateList.addLast();
-  RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  makeRoom();
 
-  s.rewind();  // rewind Serializer internal buffers
+  Serializer s;
   if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
   {
-    state.message = message;
-    state.cycles = myOSystem.console().tia().cycles();
+    ByteArray data(s.data(), s.data() + s.size());
+
+    appendState(data, message, myOSystem.console().tia().cycles());
     myLastTimeMachineAdd = timeMachine;
     return true;
   }
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::appendState(ByteArray& data, const string& message, uInt64 cycles)
+{
+  // Store a keyframe at least every KEYFRAME_DISTANCE states
+  bool keyframe = true;
+  if(!myStateList.empty())
+  {
+    uInt32 distance = 1;
+    for(auto it = myStateList.last(); !it->keyframe && it != myStateList.first(); --it)
+      ++distance;
+    keyframe = distance >= KEYFRAME_DISTANCE;
+  }
+
+  if(!keyframe && !myLastDataValid)
+    decodeState(myStateList.last(), myLastData);
+
+  // Add new state at the end of the list (queue adds at end)
+  // This updates the 'current' iterator inside the list
+  myStateList.addLast();
+  RewindState& state = myStateList.current();
+
+  encodeState(state, data, keyframe ? nullptr : &myLastData);
+  state.message = message;
+  state.cycles = cycles;
+
+  // Keep the complete data as the base for the next state
+  std::swap(myLastData, data);
+  myLastDataValid = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::rewindStates(uInt32 numStates)
 {
@@ -161,10 +292,6 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
         // ...except when the last state was added automatically,
         // because that already happened one interval before
         myLastTimeMachineAdd = false;
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
@@ -196,10 +323,6 @@ uInt32 RewindManager::unwindStates(uInt32 numStates)
       // Set internal current iterator to nextCycles state (forward in time),
       // since we will now process this state
       myStateList.moveToNext();
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
@@ -243,37 +366,23 @@ string RewindManager::saveAllStates()
     if (!out)
       return "Can't save to all states file";
 
-    uInt32 curIdx = getCurrentIdx();
-    rewindStates(MAX_BUF_SIZE);
-    uInt32 numStates = uInt32(cyclesList().size());
+    const uInt32 numStates = myStateList.size();
 
     // Save header
     buf.str("");
     out.putString(STATE_HEADER);
     out.putShort(numStates);
 
-    for (uInt32 i = 0; i < numStates; ++i)
+    ByteArray data;
+    for(auto it = myStateList.first(); it != myStateList.cend(); ++it)
     {
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      uInt32 stateSize = uInt32(s.size());
-      unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(stateSize);
-
-      out.putInt(stateSize);
-
-      // Rewind Serializer internal buffers
-      s.rewind();
-
-      // Save state
-      s.getByteArray(buffer.get(), stateSize);
-      out.putByteArray(buffer.get(), stateSize);
-      out.putString(state.message);
-      out.putLong(state.cycles);
-
-      unwindStates(1);
+      // Save the complete state
+      decodeState(it, data);
+      out.putInt(uInt32(data.size()));
+      out.putByteArray(data.data(), data.size());
+      out.putString(it->message);
+      out.putLong(it->cycles);
     }
-    // restore old state position
-    rewindStates(numStates - curIdx);
 
     buf.str("");
     buf << "Saved " << numStates << " states";
@@ -312,26 +421,16 @@ string RewindManager::loadAllStates()
 
     for (uInt32 i = 0; i < numStates; ++i)
     {
-      if (myStateList.full())
-        compressStates();
-
-      uInt32 stateSize = in.getInt();
-      unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(stateSize);
-
-      // Add new state at the end of the list (queue adds at end)
-      // This updates the 'current' iterator inside the list
-      myStateList.addLast();
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-
-      // Rewind Serializer internal buffers
-      s.rewind();
-
-      // Fill new state with saved values
-      in.getByteArray(buffer.get(), stateSize);
-      s.putByteArray(buffer.get(), stateSize);
-      state.message = in.getString();
-      state.cycles = in.getLong();
+      makeRoom();
+
+      ByteArray data(in.getInt());
+
+      // Add new state at the end of the list
+      in.getByteArray(data.data(), data.size());
+      const string message = in.getString();
+      const uInt64 cycles = in.getLong();
+
+      appendState(data, message, cycles);
     }
 
     // initialize current state (parameters ignored)
@@ -347,12 +446,31 @@ string RewindManager::loadAllStates()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::makeRoom()
+{
+  // Make sure we never run out of space or memory
+  if(myStateList.full())
+  {
+    if(myMemoryBudget > 0 && myMemoryUsed < myMemoryBudget &&
+       myStateList.capacity() < MAX_BUDGET_SIZE)
+      myStateList.grow(std::min(myStateList.capacity() * 2, MAX_BUDGET_SIZE));
+    else
+      compressStates();
+  }
+  while(myMemoryBudget > 0 && myStateList.size() > 1 && myMemoryUsed > myMemoryBudget)
+    compressStates();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::compressStates()
 {
   double expectedCycles = myInterval * myFactor * (1 + myFactor);
   double maxError = 1.5;
   uInt32 idx = myStateList.size() - 2;
+  // the newest states are not compressed; this equals mySize - myUncompressed
+  // when the list is full, but also applies to lists grown within the budget
+  const uInt32 compressed = myStateList.size() - std::min(myStateList.size(), myUncompressed);
   // in case maxError is <= 1.5 remove first state by default:
   Common::LinkedObjectPool<RewindState>::const_iter removeIter = myStateList.first();
   /*if(myUncompressed < mySize)
@@ -362,7 +480,7 @@ void RewindManager::compressStates()
   // iterate from last but one to first but one
   for(auto it = myStateList.previous(myStateList.last()); it != myStateList.first(); --it)
   {
-    if(idx < mySize - myUncompressed)
+    if(idx < compressed)
     {
       expectedCycles *= myFactor;
 
@@ -378,14 +496,79 @@ void RewindManager::compressStates()
     }
     --idx;
   }
-   myStateList.remove(removeIter); // remove
+  unlinkState(removeIter);
+  releaseState(stateAt(removeIter));
+  myStateList.remove(removeIter); // remove
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::unlinkState(StateIter it)
+{
+  const StateIter next = myStateList.next(it);
+
+  // Only a following difference depends on the state
+  if(next == myStateList.cend() || next->keyframe)
+    return;
+
+  ByteArray data, base;
+  decodeState(next, data);
+
+  // The following state becomes a keyframe if the removed one was one
+  if(it->keyframe)
+    encodeState(stateAt(next), data, nullptr);
+  else
+  {
+    decodeState(myStateList.previous(it), base);
+    encodeState(stateAt(next), data, &base);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::releaseState(RewindState& state)
+{
+  myMemoryUsed -= state.data.size();
+  ByteArray().swap(state.data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeState(StateIter it, ByteArray& data) const
+{
+  // Find the keyframe this state is based on...
+  StateIter key = it;
+  while(!key->keyframe && key != myStateList.first())
+    --key;
+
+  // ...and apply all differences from there on
+  data.clear();
+  for(++it; key != it; ++key)
+    decodeDelta(key->data, key->size, data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeState(RewindState& state, const ByteArray& data,
+                                const ByteArray* base)
+{
+  static const ByteArray NO_BASE;
+  ByteArray delta;
+
+  encodeDelta(data, base ? *base : NO_BASE, delta);
+
+  // Copy, so that the state does not keep any spare capacity
+  myMemoryUsed -= state.data.size();
+  state.data = ByteArray(delta.begin(), delta.end());
+  myMemoryUsed += state.data.size();
+  state.size = uInt32(data.size());
+  state.keyframe = base == nullptr;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 {
-  RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  const RewindState& state = myStateList.current();
+  ByteArray data;
+  decodeState(myStateList.currentIter(), data);
+
+  Serializer s(data.data(), data.size(), Serializer::Mode::ReadOnly);
 
   myStateManager.loadState(s);
   myOSystem.console().tia().loadDisplay(s);
@@ -440,6 +623,23 @@ string RewindManager::getUnitString(Int64 cycles)
   return result.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::resize(uInt32 size)
+{
+  clear();
+  myStateList.resize(size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+  for(auto it = myStateList.first(); it != myStateList.cend(); ++it)
+    releaseState(stateAt(it));
+
+  myStateList.clear();
+  myLastDataValid = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getFirstCycles() const
 {
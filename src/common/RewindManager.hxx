@@ -39,7 +39,17 @@ class StateManager;
   iterator moves to the insertion point of the data (the end of the list).
 
   If the list is full, states are either removed at the beginning (compression
-  off) or at selective positions (compression on).
+  off) or at selective positions (compression on).  With a memory budget, the
+  number of states is not limited by the list size; the list grows until the
+  states exceed the budget, and states are removed from then on.  Beyond the
+  list size, the states continue the spacing used by compression, so the
+  budget extends the horizon.
+
+  To save memory, only every KEYFRAME_DISTANCE-th state is stored completely
+  (a keyframe); all others are stored as the XOR difference to the previous
+  state, with runs of unchanged bytes skipped.  When a state is removed, the
+  following state is re-encoded, so that any state can always be restored
+  from the closest keyframe before it.
 
   @author  Stephen Anthony
 */
@@ -50,6 +60,11 @@ class RewindManager
 
   public:
     static constexpr uInt32 MAX_BUF_SIZE = 1000;
+    // maximum number of states with a memory budget (limited by the number
+    // of states in the all states file)
+    static constexpr uInt32 MAX_BUDGET_SIZE = 0xffff;
+    // maximum number of states between two completely stored states
+    static constexpr uInt32 KEYFRAME_DISTANCE = 16;
     static constexpr int NUM_INTERVALS = 7;
     // cycle values for the intervals
     const std::array<uInt32, NUM_INTERVALS> INTERVAL_CYCLES = {
@@ -142,10 +157,8 @@ class RewindManager
 
     bool atFirst() const { return myStateList.atFirst(); }
     bool atLast() const  { return myStateList.atLast();  }
-    void resize(uInt32 size) { myStateList.resize(size); }
-    void clear() {
-      myStateList.clear();
-    }
+    void resize(uInt32 size);
+    void clear();
 
     /**
       Convert the cycles into a unit string.
@@ -160,6 +173,11 @@ class RewindManager
     uInt64 getLastCycles() const;
     uInt64 getInterval() const { return myInterval; }
 
+    /**
+      The number of bytes currently used by all states in the list.
+    */
+    size_t memoryUsed() const { return myMemoryUsed; }
+
     /**
       Get a collection of cycle timestamps, offset from the first one in
       the list.  This also determines the number of states in the list.
@@ -176,9 +194,13 @@ class RewindManager
     uInt64 myHorizon{0};
     double myFactor{0.0};
     bool   myLastTimeMachineAdd{false};
+    size_t myMemoryBudget{0}; // in bytes, 0 = unlimited
+    size_t myMemoryUsed{0};   // by the data of all states
 
     struct RewindState {
-      Serializer data;  // actual save state
+      ByteArray data;   // keyframe or difference to the previous state
+      uInt32 size{0};   // size of the complete state
+      bool keyframe{false};
       string message;   // describes save state origin
       uInt64 cycles{0}; // cycles since emulation started
 
@@ -197,12 +219,61 @@ class RewindManager
     // The linked-list to store states (internally it takes care of reducing
     // frequent (de)-allocations)
     Common::LinkedObjectPool<RewindState> myStateList;
+    using StateIter = Common::LinkedObjectPool<RewindState>::const_iter;
+
+    // The complete data of the last state in the list (if valid), used as
+    // the base for the next difference
+    ByteArray myLastData;
+    bool myLastDataValid{false};
+
+    /**
+      Make room for a new state, by growing the list (within the memory
+      budget) or by removing states.
+    */
+    void makeRoom();
 
     /**
       Remove a save state from the list
     */
     void compressStates();
 
+    /**
+      Add the given complete state at the end of the list, stored either
+      as a keyframe or as a difference to the previous state.
+    */
+    void appendState(ByteArray& data, const string& message, uInt64 cycles);
+
+    /**
+      Prepare the removal of the given state from the list: the following
+      state is re-encoded so that it no longer depends on it.
+    */
+    void unlinkState(StateIter it);
+
+    /**
+      Free the memory of the given state, which is about to be removed.
+    */
+    void releaseState(RewindState& state);
+
+    /**
+      The list only hands out const iterators, but its nodes themselves
+      can be modified.
+    */
+    static RewindState& stateAt(StateIter it) {
+      return const_cast<RewindState&>(*it);
+    }
+
+    /**
+      Restore the complete data of the given state.
+    */
+    void decodeState(StateIter it, ByteArray& data) const;
+
+    /**
+      Encode the data into the given state, either as a keyframe (no base)
+      or as the difference to the given base.
+    */
+    void encodeState(RewindState& state, const ByteArray& data,
+                     const ByteArray* base);
+
     /**
       Load the current state and get the message string for the rewind/unwind
 
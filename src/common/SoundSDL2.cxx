@@ -198,7 +198,16 @@ void SoundSDL2::close()
 
   mute(true);
 
-  if (myAudioQueue) myAudioQueue->closeSink(myCurrentFragment);
+  if (myAudioQueue) {
+    const AudioQueue::Statistics stats = myAudioQueue->statistics();
+    ostringstream buf;
+
+    buf << "Audio queue: peak fill " << stats.peakSize << "/" << stats.capacity
+        << ", " << stats.overflows << " overflows, " << stats.underruns << " underruns";
+    Logger::debug(buf.str());
+
+    myAudioQueue->closeSink(myCurrentFragment);
+  }
   myAudioQueue.reset();
   myCurrentFragment = nullptr;
 }
@@ -22,6 +22,7 @@
 #include "Control.hxx"
 #include "Switches.hxx"
 #include "System.hxx"
+#include "TIA.hxx"
 #include "Serializable.hxx"
 #include "RewindManager.hxx"
 
@@ -374,6 +375,27 @@ bool StateManager::saveState(Serializer& out)
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t StateManager::stateSize()
+{
+  Serializer out(Serializer::SizeOnly{});
+
+  return saveState(out) ? out.size() : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t StateManager::maxStateSize()
+{
+  const size_t size = stateSize();
+  if(size == 0)
+    return 0;
+
+  // Only the TIA state changes its size while running
+  const TIA& tia = myOSystem.console().tia();
+
+  return size - tia.stateSize() + tia.maxStateSize();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
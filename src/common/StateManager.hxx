@@ -18,7 +18,7 @@
 #ifndef STATE_MANAGER_HXX
 #define STATE_MANAGER_HXX
 
-#define STATE_HEADER "06020100state"
+#define STATE_HEADER "06050000state"
 
 class OSystem;
 class RewindManager;
@@ -145,6 +145,22 @@ class StateManager
     */
     bool saveState(Serializer& out);
 
+    /**
+      Get the exact size of the state saveState(Serializer&) would write
+      right now, without storing it.
+
+      @return  The size of the state, or 0 on any errors
+    */
+    size_t stateSize();
+
+    /**
+      Get an upper bound for the size of the state saveState(Serializer&)
+      writes, which holds until another ROM is loaded.
+
+      @return  The maximum size of the state, or 0 on any errors
+    */
+    size_t maxStateSize();
+
     /**
       Resets manager to defaults.
     */
@@ -17,29 +17,92 @@
 
 #include "ConvolutionBuffer.hxx"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define CONVOLUTION_SSE2
+  #include <emmintrin.h>
+#elif defined(__GNUC__)
+  // Generic vectors, which map to NEON on ARM
+  #define CONVOLUTION_VECTOR
+  using float4 = float __attribute__((vector_size(16)));
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-ConvolutionBuffer::ConvolutionBuffer(uInt32 size)
-  : myData{make_unique<float[]>(size)},
-    mySize{size}
+ConvolutionBuffer::ConvolutionBuffer(uInt32 size, uInt32 channels)
+  : myData{make_unique<float[]>(2 * size * channels)},
+    mySize{size},
+    myChannels{channels}
 {
-  std::fill_n(myData.get(), mySize, 0.F);
+  std::fill_n(myData.get(), 2 * mySize * myChannels, 0.F);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ConvolutionBuffer::shift(float nextValue)
 {
-  myData[myFirstIndex] = nextValue;
-  myFirstIndex = (myFirstIndex + 1) % mySize;
+  myData[myFirstIndex] = myData[myFirstIndex + mySize] = nextValue;
+
+  if (++myFirstIndex == mySize) myFirstIndex = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::shift(float nextValueL, float nextValueR)
+{
+  float* first = myData.get() + 2 * myFirstIndex;
+
+  first[0] = first[2 * mySize] = nextValueL;
+  first[1] = first[2 * mySize + 1] = nextValueR;
+
+  if (++myFirstIndex == mySize) myFirstIndex = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+float ConvolutionBuffer::convoluteWith(const float* kernel) const
+{
+  float lanes[4];
+  accumulate(kernel, lanes);
+
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float ConvolutionBuffer::convoluteWith(float* kernel) const
+void ConvolutionBuffer::convoluteWith(const float* kernel, float& resultL, float& resultR) const
 {
-  float result = 0.F;
+  // Left and right samples alternate, so they end up in even and odd lanes
+  float lanes[4];
+  accumulate(kernel, lanes);
+
+  resultL = lanes[0] + lanes[2];
+  resultR = lanes[1] + lanes[3];
+}
 
-  for (uInt32 i = 0; i < mySize; ++i) {
-    result += kernel[i] * myData[(myFirstIndex + i) % mySize];
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void ConvolutionBuffer::accumulate(const float* kernel, float* lanes) const
+{
+  const float* data = myData.get() + myFirstIndex * myChannels;
+  const uInt32 count = mySize * myChannels;
+
+#if defined(CONVOLUTION_SSE2)
+  __m128 sum = _mm_setzero_ps();
+
+  for (uInt32 i = 0; i < count; i += 4)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + i), _mm_loadu_ps(data + i)));
+
+  _mm_storeu_ps(lanes, sum);
+#elif defined(CONVOLUTION_VECTOR)
+  float4 sum = {0.F, 0.F, 0.F, 0.F};
+
+  for (uInt32 i = 0; i < count; i += 4) {
+    float4 k, d;
+    __builtin_memcpy(&k, kernel + i, sizeof(float4));
+    __builtin_memcpy(&d, data + i, sizeof(float4));
+    sum += k * d;
   }
 
-  return result;
+  __builtin_memcpy(lanes, &sum, sizeof(float4));
+#else
+  std::fill_n(lanes, 4, 0.F);
+
+  for (uInt32 i = 0; i < count; i += 4)
+    for (uInt32 lane = 0; lane < 4; ++lane)
+      lanes[lane] += kernel[i + lane] * data[i + lane];
+#endif
 }
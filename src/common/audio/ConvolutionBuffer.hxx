@@ -20,15 +20,43 @@
 
 #include "bspf.hxx"
 
+/**
+  The sample history for convolving with a kernel, for one or two (stereo,
+  interleaved) channels.
+
+  The history is stored twice in a row, so that the last 'size' samples are
+  always contiguous in memory and can be convoluted without any wrapping.
+  The convolution runs on four lanes at once (using SSE2 or NEON where
+  available); 'size' must thus be a multiple of four.
+*/
 class ConvolutionBuffer
 {
   public:
 
-    explicit ConvolutionBuffer(uInt32 size);
+    ConvolutionBuffer(uInt32 size, uInt32 channels);
 
     void shift(float nextValue);
 
-    float convoluteWith(float* kernel) const;
+    void shift(float nextValueL, float nextValueR);
+
+    /**
+      Convolute the mono history with a kernel of 'size' values.
+    */
+    float convoluteWith(const float* kernel) const;
+
+    /**
+      Convolute the stereo history with a kernel of 'size' pairs of
+      identical values (one for each channel).
+    */
+    void convoluteWith(const float* kernel, float& resultL, float& resultR) const;
+
+  private:
+
+    /**
+      Multiply 'myData' and 'kernel' elementwise, and sum up each of the
+      four lanes separately.
+    */
+    void accumulate(const float* kernel, float* lanes) const;
 
   private:
 
@@ -38,6 +66,8 @@ class ConvolutionBuffer
 
     uInt32 mySize{0};
 
+    uInt32 myChannels{1};
+
   private:
 
     ConvolutionBuffer() = delete;
@@ -70,21 +70,15 @@ LanczosResampler::LanczosResampler(
   //
   // -> we find N from fully reducing the fraction.
   myPrecomputedKernelCount{reducedDenominator(formatFrom.sampleRate, formatTo.sampleRate)},
-  myKernelSize{2 * kernelParameter},
+  myKernelSize{(2 * kernelParameter + 3) & ~3U},
+  myChannels{formatFrom.stereo ? 2U : 1U},
   myKernelParameter{kernelParameter},
   myHighPassL{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)},
   myHighPassR{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)},
   myHighPass{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)}
 {
-  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelSize);
-
-  if (myFormatFrom.stereo)
-  {
-    myBufferL = make_unique<ConvolutionBuffer>(myKernelSize);
-    myBufferR = make_unique<ConvolutionBuffer>(myKernelSize);
-  }
-  else
-    myBuffer = make_unique<ConvolutionBuffer>(myKernelSize);
+  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelSize * myChannels);
+  myBuffer = make_unique<ConvolutionBuffer>(myKernelSize, myChannels);
 
   precomputeKernels();
 }
@@ -95,16 +89,23 @@ void LanczosResampler::precomputeKernels()
   // timeIndex = time * formatFrom.sampleRate * formatTo.sampleRAte
   uInt32 timeIndex = 0;
 
+  // The taps are stored in the layout of the convolution buffer: padded with
+  // leading zeros (which hit the oldest samples), and duplicated for stereo
+  const uInt32 padding = myKernelSize - 2 * myKernelParameter;
+  std::fill_n(myPrecomputedKernels.get(), myPrecomputedKernelCount * myKernelSize * myChannels, 0.F);
+
   for (uInt32 i = 0; i < myPrecomputedKernelCount; ++i) {
-    float* kernel = myPrecomputedKernels.get() + myKernelSize * i;
+    float* kernel = myPrecomputedKernels.get() + myKernelSize * myChannels * i;
     // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate
     float center =
       static_cast<float>(timeIndex) / static_cast<float>(myFormatTo.sampleRate);
 
     for (uInt32 j = 0; j < 2 * myKernelParameter; ++j) {
-      kernel[j] = lanczosKernel(
+      const float value = lanczosKernel(
           center - static_cast<float>(j) + static_cast<float>(myKernelParameter) - 1.F, myKernelParameter
         ) * CLIPPING_FACTOR;
+
+      std::fill_n(kernel + (padding + j) * myChannels, myChannels, value);
     }
 
     // Next step: time += 1 / formatTo.sampleRate
@@ -143,12 +144,12 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
 
   for (uInt32 i = 0; i < outputSamples; ++i) {
-    float* kernel = myPrecomputedKernels.get() + (myCurrentKernelIndex * myKernelSize);
-    myCurrentKernelIndex = (myCurrentKernelIndex + 1) % myPrecomputedKernelCount;
+    const float* kernel = myPrecomputedKernels.get() + (myCurrentKernelIndex * myKernelSize * myChannels);
+    if (++myCurrentKernelIndex == myPrecomputedKernelCount) myCurrentKernelIndex = 0;
 
     if (myFormatFrom.stereo) {
-      float sampleL = myBufferL->convoluteWith(kernel);
-      float sampleR = myBufferR->convoluteWith(kernel);
+      float sampleL, sampleR;
+      myBuffer->convoluteWith(kernel, sampleL, sampleR);
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -179,10 +180,11 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
 inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
 {
   while (samplesToShift-- > 0) {
-    if (myFormatFrom.stereo) {
-      myBufferL->shift(myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)));
-      myBufferR->shift(myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff)));
-    }
+    if (myFormatFrom.stereo)
+      myBuffer->shift(
+        myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)),
+        myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff))
+      );
     else
       myBuffer->shift(myHighPass.apply(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff)));
 
@@ -44,15 +44,15 @@ class LanczosResampler : public Resampler
   private:
 
     uInt32 myPrecomputedKernelCount{0};
+    // The number of taps, padded for the convolution buffer
     uInt32 myKernelSize{0};
+    uInt32 myChannels{1};
     uInt32 myCurrentKernelIndex{0};
     unique_ptr<float[]> myPrecomputedKernels;
 
     uInt32 myKernelParameter{0};
 
     unique_ptr<ConvolutionBuffer> myBuffer;
-    unique_ptr<ConvolutionBuffer> myBufferL;
-    unique_ptr<ConvolutionBuffer> myBufferR;
 
     Int16* myCurrentFragment{nullptr};
     uInt32 myFragmentIndex{0};
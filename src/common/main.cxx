@@ -33,6 +33,7 @@
 #include "System.hxx"
 #include "TIASurface.hxx"
 #include "ProfilingRunner.hxx"
+#include "BatchRunner.hxx"
 
 #include "ThreadDebugging.hxx"
 
@@ -74,6 +75,12 @@ void checkForCustomBaseDir(Settings::Options& options);
 */
 bool isProfilingRun(int ac, char* av[]);
 
+/**
+  Checks whether the commandline contains an argument corresponding to
+  starting a headless batch session.
+*/
+bool isBatchRun(int ac, char* av[]);
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void parseCommandLine(int ac, char* av[],
     Settings::Options& globalOpts, Settings::Options& localOpts)
@@ -153,6 +160,13 @@ bool isProfilingRun(int ac, char* av[]) {
   return string(av[1]) == "-profile";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isBatchRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-batch";
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 #if defined(BSPF_MACOS)
 int stellaMain(int ac, char* av[])
@@ -178,6 +192,20 @@ int main(int ac, char* av[])
     }
   }
 
+  if (isBatchRun(ac, av)) {
+    BatchRunner runner(ac, av);
+
+    try
+    {
+      return runner.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
   unique_ptr<OSystem> theOSystem;
 
   auto Cleanup = [&theOSystem]() {
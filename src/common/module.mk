@@ -21,6 +21,7 @@ MODULE_OBJS := \
 	src/common/PJoystickHandler.o \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
+	src/common/RenderKernels.o \
 	src/common/RewindManager.o \
 	src/common/SoundSDL2.o \
 	src/common/StaggeredLogger.o \
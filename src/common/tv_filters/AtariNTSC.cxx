@@ -18,6 +18,7 @@
 #include <thread>
 #include "AtariNTSC.hxx"
 #include "PhosphorHandler.hxx"
+#include "RenderKernels.hxx"
 
 // blitter related
 #ifndef restrict
@@ -80,8 +81,10 @@ void AtariNTSC::generateKernels()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::enableThreading(bool enable)
+void AtariNTSC::enableThreading(bool enable, uInt32 numThreads)
 {
+  stopWorkers();
+
   uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
   if(systemThreads <= 1)
   {
@@ -90,12 +93,63 @@ void AtariNTSC::enableThreading(bool enable)
   }
   else
   {
-    systemThreads = std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1));
+    // Leave one core for the emulation itself
+    const uInt32 maxThreads = numThreads > 0 ? numThreads : 4;
+    systemThreads = std::max<uInt32>(1, std::min<uInt32>(maxThreads, systemThreads - 1));
 
     myWorkerThreads = systemThreads - 1;
     myTotalThreads  = systemThreads;
 
-    myThreads = make_unique<std::thread[]>(myWorkerThreads);  // NOLINT
+    startWorkers();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::startWorkers()
+{
+  myStopWorkers = false;
+  myThreads.reserve(myWorkerThreads);
+
+  for(uInt32 i = 0; i < myWorkerThreads; ++i)
+    myThreads.emplace_back(&AtariNTSC::workerLoop, this, i+1, myJobGeneration);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::stopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(myJobMutex);
+    myStopWorkers = true;
+  }
+  myJobStarted.notify_all();
+
+  for(auto& thread: myThreads)
+    thread.join();
+
+  myThreads.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::workerLoop(uInt32 threadNum, uInt32 generation)
+{
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myJobMutex);
+      myJobStarted.wait(lock, [&] {
+        return myStopWorkers || myJobGeneration != generation;
+      });
+      if(myStopWorkers)
+        return;
+
+      generation = myJobGeneration;
+    }
+
+    renderSlice(threadNum);
+
+    std::lock_guard<std::mutex> lock(myJobMutex);
+    if(--myPendingWorkers == 0)
+      myJobFinished.notify_one();
   }
 }
 
@@ -103,28 +157,42 @@ void AtariNTSC::enableThreading(bool enable)
 void AtariNTSC::render(const uInt8* atari_in, const uInt32 in_width, const uInt32 in_height,
   void* rgb_out, const uInt32 out_pitch, uInt32* rgb_in)
 {
-  // Spawn the threads...
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
+  myJob = RenderJob{atari_in, in_width, in_height, rgb_out, out_pitch, rgb_in};
+
+  // Wake up the workers...
+  if(myWorkerThreads > 0)
   {
-    myThreads[i] = std::thread([=] {
-    rgb_in == nullptr ?
-      renderThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_out, out_pitch) :
-      renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_in, rgb_out, out_pitch);
-    });
+    {
+      std::lock_guard<std::mutex> lock(myJobMutex);
+      myPendingWorkers = myWorkerThreads;
+      ++myJobGeneration;
+    }
+    myJobStarted.notify_all();
   }
   // Make the main thread busy too
-  rgb_in == nullptr ?
-    renderThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_out, out_pitch) :
-    renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_in, rgb_out, out_pitch);
-  // ...and make them join again
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-    myThreads[i].join();
+  renderSlice(0);
+  // ...and wait until they are done
+  if(myWorkerThreads > 0)
+  {
+    std::unique_lock<std::mutex> lock(myJobMutex);
+    myJobFinished.wait(lock, [&] { return myPendingWorkers == 0; });
+  }
 
   // Copy phosphor values into out buffer
   if(rgb_in != nullptr)
     memcpy(rgb_out, rgb_in, in_height * out_pitch);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::renderSlice(uInt32 threadNum)
+{
+  myJob.rgb_in == nullptr ?
+    renderThread(myJob.atari_in, myJob.in_width, myJob.in_height,
+                 myTotalThreads, threadNum, myJob.rgb_out, myJob.out_pitch) :
+    renderWithPhosphorThread(myJob.atari_in, myJob.in_width, myJob.in_height,
+                 myTotalThreads, threadNum, myJob.rgb_in, myJob.rgb_out, myJob.out_pitch);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
   const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
@@ -270,29 +338,14 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
     ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
 #endif
 
-    // Do phosphor mode (blend the resulting frames)
+    // Do phosphor mode (blend the resulting frames), storing back into the
+    // displayed frame buffer (for next frame)
     // Note: The unrolled code assumed that AtariNTSC::outWidth(kTIAW) == outPitch == 565
     // Now this got changed to 568 so the final 5 calculations got removed.
-    for (uInt32 x = AtariNTSC::outWidth(in_width) / 8; x; --x)
-    {
-      // Store back into displayed frame buffer (for next frame)
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-    }
+    const uInt32 phosphorWidth = AtariNTSC::outWidth(in_width) / 8 * 8;
+    RenderKernels::blendPhosphor(out + bufofs, rgb_in + bufofs, nullptr,
+                                 phosphorWidth, PhosphorHandler::decay());
+    bufofs += phosphorWidth;
     // finish final 565 % 8 = 5 pixels
     /*rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
     ++bufofs;
@@ -41,6 +41,8 @@
 #define ATARI_NTSC_HXX
 
 #include <cmath>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "FrameBufferConstants.hxx"
@@ -51,6 +53,7 @@ class AtariNTSC
   public:
     // By default, threading is turned off and palette is blank
     AtariNTSC() { enableThreading(false); myRGBPalette.fill(0); }
+    ~AtariNTSC() { stopWorkers(); }
 
     // Image parameters, ranging from -1.0 to 1.0. Actual internal values shown
     // in parenthesis and should remain fairly stable in future versions.
@@ -79,8 +82,11 @@ class AtariNTSC
     // Set palette for normal Blarrg mode
     void setPalette(const PaletteArray& palette);
 
-    // Set up threading
-    void enableThreading(bool enable);
+    // Set up threading; the worker threads are kept alive until threading
+    // is reconfigured.  A thread count of 0 selects a sensible default
+    // (up to 4 threads), otherwise the count is only limited by the number
+    // of available cores.
+    void enableThreading(bool enable, uInt32 numThreads = 0);
 
     // Filters one or more rows of pixels. Input pixels are 8-bit Atari
     // palette colors.
@@ -100,6 +106,17 @@ class AtariNTSC
     // Generate kernels from raw RGB palette
     void generateKernels();
 
+    // Start/stop the persistent worker threads
+    void startWorkers();
+    void stopWorkers();
+
+    // Main loop of a worker thread, waiting for and rendering its slice of
+    // each frame
+    void workerLoop(uInt32 threadNum, uInt32 generation);
+
+    // Render the given thread's slice of the current job
+    void renderSlice(uInt32 threadNum);
+
     // Threaded rendering
     void renderThread(const uInt8* atari_in, const uInt32 in_width,
       const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, void* rgb_out, const uInt32 out_pitch);
@@ -149,10 +166,30 @@ class AtariNTSC
     BSPF::array2D<uInt32, palette_size, entry_size> myColorTable;
 
     // Rendering threads
-    unique_ptr<std::thread[]> myThreads;  // NOLINT
+    vector<std::thread> myThreads;
     // Number of rendering and total threads
     uInt32 myWorkerThreads{0}, myTotalThreads{0};
 
+    // The frame currently being rendered, shared with the worker threads
+    struct RenderJob
+    {
+      const uInt8* atari_in{nullptr};
+      uInt32 in_width{0};
+      uInt32 in_height{0};
+      void* rgb_out{nullptr};
+      uInt32 out_pitch{0};
+      uInt32* rgb_in{nullptr};
+    };
+    RenderJob myJob;
+
+    // Job hand-off between render() and the workers; each new frame bumps
+    // the generation, and the last worker to finish wakes up render()
+    std::mutex myJobMutex;
+    std::condition_variable myJobStarted, myJobFinished;
+    uInt32 myJobGeneration{0};
+    uInt32 myPendingWorkers{0};
+    bool myStopWorkers{false};
+
     struct init_t
     {
       std::array<float, burst_count * 6> to_rgb{0.F};
@@ -0,0 +1,207 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "M6532.hxx"
+#include "System.hxx"
+#include "CompiledExpression.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Expression::compile(CompiledExpression& code) const
+{
+  // Nodes without a compiled form are evaluated as a tree
+  code.emitCall(*this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CompiledExpression::CompiledExpression(Expression* expr, System& system)
+  : myExpression{expr},
+    mySystem{system}
+{
+  myExpression->compile(*this);
+  emit(Op::Return);
+
+  // Fall back to the tree if the stack could overflow
+  if(myMaxDepth > int(MAX_DEPTH))
+  {
+    myCode.clear();
+    myJumpTarget = 0;
+    emitCall(*myExpression);
+    emit(Op::Return);
+  }
+  myCode.shrink_to_fit();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emit(Op op)
+{
+  int depthChange = 0;
+
+  if(op >= Op::Add && op <= Op::Ge)
+  {
+    // A constant right operand is folded into the operation
+    if(canMerge(Op::Const))
+    {
+      const Int32 value = myCode.back().value;
+
+      // ... and so is a directly loaded left operand of a comparison
+      if(op >= Op::Eq && canMerge(Op::LoadByte, 2))
+      {
+        myCode.pop_back();
+        myCode.back().op = Op(uInt8(op) - uInt8(Op::Eq) + uInt8(Op::ByteEqImm));
+        myCode.back().value = value;
+        --myDepth;
+        return;
+      }
+      myCode.back().op = Op(uInt8(op) - uInt8(Op::Add) + uInt8(Op::AddImm));
+      --myDepth;
+      return;
+    }
+    depthChange = -1;
+  }
+
+  Instr instr;
+  instr.op = op;
+  append(instr, depthChange);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitConst(Int32 value)
+{
+  Instr instr;
+  instr.op = Op::Const;
+  instr.value = value;
+  append(instr, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitLoad(const uInt8* byte)
+{
+  Instr instr;
+  instr.op = Op::LoadByte;
+  instr.byte = byte;
+  append(instr, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitLoad(const uInt16* word)
+{
+  Instr instr;
+  instr.op = Op::LoadWord;
+  instr.word = word;
+  append(instr, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitLoad(const bool* flag, bool negate)
+{
+  Instr instr;
+  instr.op = negate ? Op::LoadNotFlag : Op::LoadFlag;
+  instr.flag = flag;
+  append(instr, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitPeek()
+{
+  // Peeks from constant addresses don't need the stack
+  if(canMerge(Op::Const))
+  {
+    Instr& instr = myCode.back();
+    const uInt16 addr = uInt16(instr.value);
+
+    // Zero-page RAM (and its mirrors) can be read directly, as long as
+    // the RIOT is actually mapped there
+    if((addr & 0x1280) == 0x0080 &&
+       mySystem.getPageAccess(addr).device == &mySystem.m6532())
+    {
+      instr.op = Op::LoadByte;
+      instr.byte = mySystem.m6532().getRAM() + (addr & 0x007f);
+    }
+    else
+      instr.op = Op::PeekConst;
+  }
+  else
+    emit(Op::Peek);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitCall(const Expression& expr)
+{
+  Instr instr;
+  instr.op = Op::Call;
+  instr.expr = &expr;
+  append(instr, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitUnary(Op op, const Expression& lhs)
+{
+  lhs.compile(*this);
+  emit(op);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitBinary(Op op, const Expression& lhs,
+                                    const Expression& rhs)
+{
+  lhs.compile(*this);
+  rhs.compile(*this);
+  emit(op);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitLogical(Op jump, const Expression& lhs,
+                                     const Expression& rhs)
+{
+  lhs.compile(*this);
+
+  // The jump keeps the result of the left side on the stack; only the
+  // fall-through path pops it
+  const size_t jumpIdx = myCode.size();
+  Instr instr;
+  instr.op = jump;
+  append(instr, -1);
+
+  rhs.compile(*this);
+  if(!isBoolean(myCode.back().op))
+    emit(Op::Bool);
+
+  myJumpTarget = myCode.size();
+  myCode[jumpIdx].value = Int32(myJumpTarget);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CompiledExpression::isBoolean(Op op)
+{
+  return (op >= Op::Eq && op <= Op::Ge) || (op >= Op::EqImm && op <= Op::GeImm) ||
+    (op >= Op::ByteEqImm && op <= Op::ByteGeImm) || op == Op::LoadFlag ||
+    op == Op::LoadNotFlag || op == Op::LogNot || op == Op::Bool;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::append(const Instr& instr, int depthChange)
+{
+  myCode.push_back(instr);
+  myDepth += depthChange;
+  myMaxDepth = std::max(myMaxDepth, myDepth);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 CompiledExpression::peek(Int32 addr) const
+{
+  return mySystem.peek(uInt16(addr));
+}
@@ -0,0 +1,247 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef COMPILED_EXPRESSION_HXX
+#define COMPILED_EXPRESSION_HXX
+
+class System;
+
+#include "bspf.hxx"
+#include "Expression.hxx"
+
+/**
+  An expression tree compiled into a flat stack bytecode.
+
+  Conditional breakpoints, conditional savestates and trap conditions are
+  evaluated after every instruction, so walking the tree through virtual
+  calls would slow down emulation considerably.  The bytecode reads CPU
+  registers and zero-page RAM through direct pointers, and accesses the
+  rest of the address space through the System, without going through the
+  Debugger.  Anything else (e.g. user functions, or TIA and RIOT methods)
+  falls back to evaluating the respective subtree.
+
+  The compiled expression takes ownership of the tree, and evaluates to
+  exactly the same value.
+
+  @author  Stella Team
+*/
+class CompiledExpression
+{
+  public:
+    enum class Op: uInt8 {
+      Const,        // push value
+      LoadByte,     // push *byte
+      LoadWord,     // push *word
+      LoadFlag,     // push *flag
+      LoadNotFlag,  // push !*flag
+      PeekConst,    // push peek(value)
+      Peek,         // replace address with peek(address)
+      DPeek,        // replace address with 16 bit peek(address)
+      Call,         // push expr->evaluate()
+
+      Neg, BinNot, LogNot, LoByte, HiByte,
+      Add, Sub, Mul, Div, Mod, And, Or, Xor, Shl, Shr,
+      Eq, Ne, Lt, Le, Gt, Ge,
+      // the same binary operations (in the same order), with a constant
+      // right operand in value
+      AddImm, SubImm, MulImm, DivImm, ModImm, AndImm, OrImm, XorImm,
+      ShlImm, ShrImm, EqImm, NeImm, LtImm, LeImm, GtImm, GeImm,
+      // the same comparisons (in the same order), with a direct byte load
+      // as left operand
+      ByteEqImm, ByteNeImm, ByteLtImm, ByteLeImm, ByteGtImm, ByteGeImm,
+
+      AndJump,      // if top is zero, jump to value; else pop
+      OrJump,       // if top is non-zero, set it to one and jump; else pop
+      Bool,         // replace top with (top != 0)
+      Return
+    };
+
+  public:
+    /**
+      Compile the given expression tree, taking ownership of it.
+
+      @param expr    The expression tree to compile
+      @param system  The system to access memory through
+    */
+    CompiledExpression(Expression* expr, System& system);
+    ~CompiledExpression() = default;
+
+    /**
+      Evaluate the compiled expression.
+    */
+    Int32 evaluate() const
+    {
+      // The top of the stack is kept in 'top', the rest in 'stack'
+      std::array<Int32, MAX_DEPTH> stack;
+      Int32* sp = stack.data();
+      Int32 top = 0;
+
+      for(const Instr* ip = myCode.data(); ; ++ip)
+      {
+        switch(ip->op)
+        {
+          case Op::Const:       *sp++ = top;  top = ip->value;        break;
+          case Op::LoadByte:    *sp++ = top;  top = *ip->byte;        break;
+          case Op::LoadWord:    *sp++ = top;  top = *ip->word;        break;
+          case Op::LoadFlag:    *sp++ = top;  top = *ip->flag;        break;
+          case Op::LoadNotFlag: *sp++ = top;  top = !*ip->flag;       break;
+          case Op::PeekConst:   *sp++ = top;  top = peek(ip->value);  break;
+          case Op::Call:        *sp++ = top;  top = ip->expr->evaluate(); break;
+          case Op::Peek:        top = peek(top);                      break;
+          case Op::DPeek:       top = peek(top) | (peek(top + 1) << 8); break;
+
+          case Op::Neg:    top = -top;               break;
+          case Op::BinNot: top = ~top;               break;
+          case Op::LogNot: top = !top;               break;
+          case Op::LoByte: top = 0xff & top;         break;
+          case Op::HiByte: top = 0xff & (top >> 8);  break;
+
+          case Op::Add: top = *--sp + top;   break;
+          case Op::Sub: top = *--sp - top;   break;
+          case Op::Mul: top = *--sp * top;   break;
+          case Op::Div: --sp;  top = top == 0 ? 0 : *sp / top;  break;
+          case Op::Mod: --sp;  top = top == 0 ? 0 : *sp % top;  break;
+          case Op::And: top = *--sp & top;   break;
+          case Op::Or:  top = *--sp | top;   break;
+          case Op::Xor: top = *--sp ^ top;   break;
+          case Op::Shl: top = *--sp << top;  break;
+          case Op::Shr: top = *--sp >> top;  break;
+          case Op::Eq:  top = *--sp == top;  break;
+          case Op::Ne:  top = *--sp != top;  break;
+          case Op::Lt:  top = *--sp < top;   break;
+          case Op::Le:  top = *--sp <= top;  break;
+          case Op::Gt:  top = *--sp > top;   break;
+          case Op::Ge:  top = *--sp >= top;  break;
+
+          case Op::AddImm: top += ip->value;  break;
+          case Op::SubImm: top -= ip->value;  break;
+          case Op::MulImm: top *= ip->value;  break;
+          case Op::DivImm: top = ip->value == 0 ? 0 : top / ip->value;  break;
+          case Op::ModImm: top = ip->value == 0 ? 0 : top % ip->value;  break;
+          case Op::AndImm: top &= ip->value;  break;
+          case Op::OrImm:  top |= ip->value;  break;
+          case Op::XorImm: top ^= ip->value;  break;
+          case Op::ShlImm: top <<= ip->value; break;
+          case Op::ShrImm: top >>= ip->value; break;
+          case Op::EqImm:  top = top == ip->value;  break;
+          case Op::NeImm:  top = top != ip->value;  break;
+          case Op::LtImm:  top = top < ip->value;   break;
+          case Op::LeImm:  top = top <= ip->value;  break;
+          case Op::GtImm:  top = top > ip->value;   break;
+          case Op::GeImm:  top = top >= ip->value;  break;
+
+          case Op::ByteEqImm: *sp++ = top;  top = *ip->byte == ip->value;  break;
+          case Op::ByteNeImm: *sp++ = top;  top = *ip->byte != ip->value;  break;
+          case Op::ByteLtImm: *sp++ = top;  top = *ip->byte < ip->value;   break;
+          case Op::ByteLeImm: *sp++ = top;  top = *ip->byte <= ip->value;  break;
+          case Op::ByteGtImm: *sp++ = top;  top = *ip->byte > ip->value;   break;
+          case Op::ByteGeImm: *sp++ = top;  top = *ip->byte >= ip->value;  break;
+
+          case Op::AndJump:
+            if(top == 0)
+              ip = myCode.data() + ip->value - 1;
+            else
+              top = *--sp;
+            break;
+          case Op::OrJump:
+            if(top != 0)
+            {
+              top = 1;
+              ip = myCode.data() + ip->value - 1;
+            }
+            else
+              top = *--sp;
+            break;
+          case Op::Bool:   top = top != 0;  break;
+          case Op::Return: return top;
+        }
+      }
+    }
+
+    /**
+      Methods used by the expression nodes to emit their code.
+    */
+    void emit(Op op);
+    void emitConst(Int32 value);
+    void emitLoad(const uInt8* byte);
+    void emitLoad(const uInt16* word);
+    void emitLoad(const bool* flag, bool negate = false);
+    void emitPeek();
+    void emitCall(const Expression& expr);
+
+    /**
+      Emit the code for a unary/binary node.
+    */
+    void emitUnary(Op op, const Expression& lhs);
+    void emitBinary(Op op, const Expression& lhs, const Expression& rhs);
+
+    /**
+      Emit the short-circuit code for a logical and/or node.
+    */
+    void emitLogical(Op jump, const Expression& lhs, const Expression& rhs);
+
+  private:
+    // Maximum depth of the evaluation stack; deeper expressions are
+    // evaluated as a tree
+    static constexpr size_t MAX_DEPTH = 32;
+
+    struct Instr {
+      Op op{Op::Return};
+      Int32 value{0};  // constant, immediate operand or jump target
+      union {
+        const uInt8* byte{nullptr};
+        const uInt16* word;
+        const bool* flag;
+        const Expression* expr;
+      };
+    };
+
+    // Append an instruction, and track the depth of the stack
+    void append(const Instr& instr, int depthChange);
+
+    // Whether the given operation always results in 0 or 1
+    static bool isBoolean(Op op);
+
+    // Whether the instruction 'back' positions from the end is the given
+    // one, and may be merged with the next instruction
+    bool canMerge(Op op, size_t back = 1) const {
+      return myCode.size() >= myJumpTarget + back && myCode[myCode.size() - back].op == op;
+    }
+
+    // Read a byte like Debugger::peek() does
+    uInt8 peek(Int32 addr) const;
+
+  private:
+    unique_ptr<Expression> myExpression;
+    System& mySystem;
+
+    vector<Instr> myCode;
+    int myDepth{0}, myMaxDepth{0};
+
+    // Instructions are never merged across the latest jump target
+    size_t myJumpTarget{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    CompiledExpression() = delete;
+    CompiledExpression(const CompiledExpression&) = delete;
+    CompiledExpression(CompiledExpression&&) = delete;
+    CompiledExpression& operator=(const CompiledExpression&) = delete;
+    CompiledExpression& operator=(CompiledExpression&&) = delete;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include "System.hxx"
 #include "Debugger.hxx"
 #include "TIADebug.hxx"
+#include "CompiledExpression.hxx"
 
 #include "CpuDebug.hxx"
 
@@ -149,6 +150,28 @@ int CpuDebug::icycles() const
   return mySystem.m6502().icycles;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CpuDebug::compile(CpuMethod method, CompiledExpression& code) const
+{
+  if(method == &CpuDebug::pc)       code.emitLoad(&my6502.PC);
+  else if(method == &CpuDebug::sp)  code.emitLoad(&my6502.SP);
+  else if(method == &CpuDebug::a)   code.emitLoad(&my6502.A);
+  else if(method == &CpuDebug::x)   code.emitLoad(&my6502.X);
+  else if(method == &CpuDebug::y)   code.emitLoad(&my6502.Y);
+  else if(method == &CpuDebug::n)   code.emitLoad(&my6502.N);
+  else if(method == &CpuDebug::v)   code.emitLoad(&my6502.V);
+  else if(method == &CpuDebug::b)   code.emitLoad(&my6502.B);
+  else if(method == &CpuDebug::d)   code.emitLoad(&my6502.D);
+  else if(method == &CpuDebug::i)   code.emitLoad(&my6502.I);
+  else if(method == &CpuDebug::z)   code.emitLoad(&my6502.notZ, true);
+  else if(method == &CpuDebug::c)   code.emitLoad(&my6502.C);
+  else if(method == &CpuDebug::icycles)  code.emitLoad(&my6502.icycles);
+  else
+    return false;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CpuDebug::setPC(int pc)
 {
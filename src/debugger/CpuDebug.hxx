@@ -20,6 +20,7 @@
 
 class M6502;
 class System;
+class CompiledExpression;
 
 // Function type for CpuDebug instance methods
 class CpuDebug;
@@ -63,6 +64,14 @@ class CpuDebug : public DebuggerSystem
 
     int icycles() const;
 
+    /**
+      Emit a direct load of the register or flag returned by the given
+      method, for use in compiled expressions.
+
+      @return  False if the method doesn't simply return a register or flag
+    */
+    bool compile(CpuMethod method, CompiledExpression& code) const;
+
     void setPC(int pc);
     void setSP(int sp);
     void setPS(int ps);
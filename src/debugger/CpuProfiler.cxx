@@ -0,0 +1,144 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Cart.hxx"
+#include "M6502.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "CpuProfiler.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuProfiler::CpuProfiler()
+  : myNodes(1)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::sample(const M6502& cpu)
+{
+  const System& system = *cpu.mySystem;
+  const uInt64 cycles = system.cycles();
+  const uInt8 bank = uInt8(system.cart().getBank(cpu.PC));
+
+  if(!myStarted)
+  {
+    myStarted = true;
+    myFirstFrame = system.tia().frameCount();
+  }
+  // Loading a state may turn back the clock
+  else if(cycles >= myLastCycles)
+  {
+    const uInt64 elapsed = cycles - myLastCycles;
+
+    myCycles[myLastKey] += elapsed;
+    myNodes[myNode].cycles += elapsed;
+    myTotalCycles += elapsed;
+
+    // The instruction register still holds the previous instruction
+    switch(cpu.IR)
+    {
+      case 0x00:  // BRK
+      case 0x20:  // JSR
+        enter(cpu.PC, bank);
+        break;
+
+      case 0x40:  // RTI
+      case 0x60:  // RTS
+        leave();
+        break;
+
+      default:
+        break;
+    }
+  }
+  myLastCycles = cycles;
+  myLastKey = key(cpu.PC, bank);
+  myFrames = system.tia().frameCount() - myFirstFrame;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::enter(uInt16 addr, uInt8 bank)
+{
+  if(myNodes[myNode].depth >= MAX_DEPTH)
+  {
+    ++myUntracked;
+    return;
+  }
+
+  const uInt32 k = key(addr, bank);
+  const auto iter = myNodes[myNode].children.find(k);
+
+  if(iter != myNodes[myNode].children.end())
+    myNode = iter->second;
+  else
+  {
+    const uInt32 child = uInt32(myNodes.size());
+    Node node;
+    node.key = k;
+    node.parent = myNode;
+    node.depth = myNodes[myNode].depth + 1;
+
+    myNodes[myNode].children.emplace(k, child);
+    myNodes.push_back(std::move(node));
+    myNode = child;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::leave()
+{
+  // Returning from the root (e.g. when profiling started inside of a
+  // subroutine) is ignored
+  if(myUntracked > 0)
+    --myUntracked;
+  else if(myNode != 0)
+    myNode = myNodes[myNode].parent;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuProfiler::HotSpotList CpuProfiler::hotSpots() const
+{
+  HotSpotList list;
+  list.reserve(myCycles.size());
+
+  for(const auto& [k, cycles]: myCycles)
+    list.push_back(HotSpot{uInt16(k), uInt8(k >> 16), cycles});
+
+  std::sort(list.begin(), list.end(), [](const HotSpot& a, const HotSpot& b) {
+    return a.cycles > b.cycles ||
+      (a.cycles == b.cycles && key(a.addr, a.bank) < key(b.addr, b.bank));
+  });
+  return list;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::saveFlameGraph(ostream& out, const NameFunction& name) const
+{
+  saveFlameGraph(out, name, 0, "(root)");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::saveFlameGraph(ostream& out, const NameFunction& name,
+                                 uInt32 node, const string& stack) const
+{
+  if(myNodes[node].cycles > 0)
+    out << stack << ' ' << myNodes[node].cycles << '\n';
+
+  for(const auto& [k, child]: myNodes[node].children)
+    saveFlameGraph(out, name, child,
+                   stack + ';' + name(uInt16(k), uInt8(k >> 16)));
+}
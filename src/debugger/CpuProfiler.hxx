@@ -0,0 +1,132 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CPU_PROFILER_HXX
+#define CPU_PROFILER_HXX
+
+class M6502;
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#include "bspf.hxx"
+
+/**
+  Attributes the cycles executed by the CPU to the instructions, and to the
+  subroutine call stacks they were executed in.
+
+  Before each instruction, the CPU passes its state to the profiler, which
+  adds the cycles elapsed since the previous instruction to that
+  instruction.  This also includes cycles the CPU was halted (e.g. by
+  WSYNC) or stalled by the cartridge.  Subroutine calls are followed by
+  watching for JSR/BRK and RTS/RTI instructions.
+
+  @author  Stella Team
+*/
+class CpuProfiler
+{
+  public:
+    // The cycles attributed to one instruction
+    struct HotSpot {
+      uInt16 addr{0};
+      uInt8 bank{0};
+      uInt64 cycles{0};
+    };
+    using HotSpotList = std::vector<HotSpot>;
+
+    // Answers the name of the code at the given address and bank
+    using NameFunction = std::function<string(uInt16 addr, uInt8 bank)>;
+
+  public:
+    CpuProfiler();
+    ~CpuProfiler() = default;
+
+    /**
+      Account for the instruction which the given CPU is about to execute.
+    */
+    void sample(const M6502& cpu);
+
+    /**
+      Answers the total number of cycles, and the number of frames
+      profiled so far.
+    */
+    uInt64 cycles() const { return myTotalCycles; }
+    uInt32 frames() const { return myFrames; }
+
+    /**
+      Answers all instructions executed so far, sorted by their cycles
+      (largest first).
+    */
+    HotSpotList hotSpots() const;
+
+    /**
+      Write the cycles per call stack in the 'folded' format used by
+      flame graph tools (one line per stack, 'caller;callee cycles').
+
+      @param out   The stream to write to
+      @param name  Names the subroutines in the stacks
+    */
+    void saveFlameGraph(ostream& out, const NameFunction& name) const;
+
+  private:
+    // Key of an address in a bank
+    static uInt32 key(uInt16 addr, uInt8 bank) { return (uInt32(bank) << 16) | addr; }
+
+    // Enter/leave a subroutine
+    void enter(uInt16 addr, uInt8 bank);
+    void leave();
+
+    // Output the stacks below the given node
+    void saveFlameGraph(ostream& out, const NameFunction& name,
+                        uInt32 node, const string& stack) const;
+
+  private:
+    // Maximum depth of the tracked call stack; deeper calls (e.g. by code
+    // which leaves subroutines without RTS) are not tracked
+    static constexpr uInt32 MAX_DEPTH = 64;
+
+    // A call stack, identified by the subroutine it ends in
+    struct Node {
+      uInt32 key{0};
+      uInt32 parent{0};
+      uInt32 depth{0};
+      uInt64 cycles{0};
+      std::map<uInt32, uInt32> children;  // subroutine key -> node
+    };
+    vector<Node> myNodes;   // the first node is the root of all stacks
+    uInt32 myNode{0};       // the current call stack
+    uInt32 myUntracked{0};  // number of calls above MAX_DEPTH
+
+    std::unordered_map<uInt32, uInt64> myCycles;  // per instruction
+
+    bool myStarted{false};
+    uInt64 myLastCycles{0};
+    uInt32 myLastKey{0};
+    uInt32 myFirstFrame{0};
+    uInt32 myFrames{0};
+    uInt64 myTotalCycles{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    CpuProfiler(const CpuProfiler&) = delete;
+    CpuProfiler(CpuProfiler&&) = delete;
+    CpuProfiler& operator=(const CpuProfiler&) = delete;
+    CpuProfiler& operator=(CpuProfiler&&) = delete;
+};
+
+#endif
@@ -338,7 +338,7 @@ int Debugger::trace()
     }
 
     unlockSystem();
-    mySystem.m6502().execute(11900000); // max. ~10 seconds
+    mySystem.m6502().execute(MAX_RUN_CYCLES);
     myOSystem.console().tia().flushLineCache();
     lockSystem();
 
@@ -349,6 +349,75 @@ int Debugger::trace()
     return step();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::runTo(const IntArray& addresses)
+{
+  const uInt64 startCycle = mySystem.cycles();
+
+  // ROM addresses are matched in all mirrors, but only in the bank the
+  // (disassembly of the) address currently belongs to
+  const auto target = [](Int32 addr) { return uInt16(addr & 0x1fff); };
+  std::vector<std::pair<uInt16, uInt8>> targets;
+  for(const Int32 addr: addresses)
+    targets.emplace_back(target(addr), myCartDebug->getBank(uInt16(addr)));
+
+  // The first instruction is stepped, so that the run can start from a
+  // target address (or a breakpoint)
+  step(false);
+
+  const uInt16 pc = target(myCpuDebug->pc());
+  const uInt8 bank = myCartDebug->getBank(myCpuDebug->pc());
+  if(std::none_of(targets.cbegin(), targets.cend(),
+                  [&](const auto& t) { return t.first == pc && t.second == bank; }))
+  {
+    // set temporary breakpoints at the targets (if not existing already)
+    std::vector<std::pair<uInt16, uInt8>> added;
+    for(const auto& t: targets)
+      if(setBreakPoint(t.first, t.second, BreakpointMap::ONE_SHOT))
+        added.push_back(t);
+
+    unlockSystem();
+    mySystem.m6502().execute(MAX_RUN_CYCLES);
+    myOSystem.console().tia().flushLineCache();
+    lockSystem();
+
+    // only the breakpoint which was hit has removed itself
+    for(const auto& t: added)
+      if(breakPoints().get(t.first, t.second) & BreakpointMap::ONE_SHOT)
+        breakPoints().erase(t.first, t.second);
+  }
+  return int(mySystem.cycles() - startCycle);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::runUntil(Expression* condition, bool& met)
+{
+  unique_ptr<Expression> cond(condition);
+  const uInt64 startCycle = mySystem.cycles();
+
+  // The first instruction is stepped, just like in 'stepwhile'
+  step(false);
+
+  met = cond->evaluate();
+  if(!met)
+  {
+    // the condition is compiled and checked by the CPU, using a temporary
+    // conditional breakpoint (which keeps the expression alive)
+    M6502& cpu = mySystem.m6502();
+    const Expression* expr = cond.get();
+    const uInt32 idx = cpu.addCondBreak(cond.release(), "rununtil");
+
+    unlockSystem();
+    cpu.execute(MAX_RUN_CYCLES);
+    myOSystem.console().tia().flushLineCache();
+    lockSystem();
+
+    met = expr->evaluate();
+    cpu.delCondBreak(idx);
+  }
+  return int(mySystem.cycles() - startCycle);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Debugger::setBreakPoint(uInt16 addr, uInt8 bank, uInt32 flags)
 {
@@ -305,6 +305,18 @@ class Debugger : public DialogContainer
 
     int step(bool save = true);
     int trace();
+
+    /**
+      Run at full speed until the PC reaches one of the given addresses
+      (in the bank currently mapped there), until the given condition becomes true (takes ownership),
+      until another breakpoint or trap is hit, or until the cycle budget
+      is used up.  Like 'step', at least one instruction is executed.
+
+      Returns the number of cycles executed; 'met' tells whether the
+      condition was true at the end
+    */
+    int runTo(const IntArray& addresses);
+    int runUntil(Expression* condition, bool& met);
     void nextScanline(int lines);
     void nextFrame(int frames);
     uInt16 rewindStates(const uInt16 numStates, string& message);
@@ -364,6 +376,9 @@ class Debugger : public DialogContainer
 
     static constexpr Int8 ANY_BANK = -1;
 
+    // Cycle budget of 'trace', 'runto' etc. (max. ~10 seconds)
+    static constexpr uInt64 MAX_RUN_CYCLES = 11900000;
+
   private:
     // rewind/unwind n states
     uInt16 windStates(uInt16 numStates, bool unwind, string& message);
@@ -36,6 +36,8 @@
 #include "RomWidget.hxx"
 #include "ProgressDialog.hxx"
 #include "TimerManager.hxx"
+#include "TraceRecorder.hxx"
+#include "CpuProfiler.hxx"
 #include "Vec.hxx"
 
 #include "Base.hxx"
@@ -526,6 +528,30 @@ cerr << "curCount         = " << curCount << endl
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FilesystemNode DebuggerParser::argFile(const string& extension) const
+{
+  // Relative names are located in the default save directory, and the
+  // default name is based on the cart name.  Cart names may contain dots
+  // (e.g. "Mr. Do!"), so only user supplied names can have an extension.
+  string file;
+  if(argCount > 0)
+  {
+    file = argStrings[0];
+    if(file.find_last_of('.') == string::npos)
+      file += extension;
+  }
+  else
+    file = debugger.myOSystem.console().properties().get(PropType::Cart_Name)
+      + extension;
+
+  FilesystemNode node(file);
+  if(!node.exists() && file.find_first_of("/\\") == string::npos)
+    node = FilesystemNode(debugger.myOSystem.defaultSaveDir().getPath() + file);
+
+  return node;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string DebuggerParser::eval()
 {
@@ -1652,6 +1678,72 @@ void DebuggerParser::executePrint()
   commandResult << eval();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "profile"
+void DebuggerParser::executeProfile()
+{
+  M6502& cpu = debugger.m6502();
+  const CpuProfiler* profiler = cpu.profiler();
+
+  if(!profiler)
+  {
+    cpu.setProfiler(make_unique<CpuProfiler>());
+    commandResult << "started profiling";
+    return;
+  }
+
+  const CartDebug& cartdbg = debugger.cartDebug();
+  const bool multiBank = debugger.myOSystem.console().cartridge().romBankCount() > 1;
+  const auto name = [&](uInt16 addr, uInt8 bank) {
+    string label = cartdbg.getLabel(addr, true, 4);
+    if(multiBank)
+      label += "#" + std::to_string(bank);
+    return label;
+  };
+
+  // Report the hot spots in total, and averaged over the profiled frames
+  const uInt64 cycles = profiler->cycles(), total = std::max<uInt64>(cycles, 1);
+  const uInt32 frames = profiler->frames(), divisor = std::max<uInt32>(frames, 1);
+  const CpuProfiler::HotSpotList hotSpots = profiler->hotSpots();
+
+  stringstream report;
+  report << dec << cycles << " cycles in " << frames << " frames"
+         << " (per frame values are averages)" << endl << endl
+         << "      cycles  cycles/frame  lines/frame       %  address" << endl;
+  for(const auto& spot: hotSpots)
+    report << std::fixed << std::setprecision(2)
+           << std::setw(12) << spot.cycles << ' '
+           << std::setw(13) << double(spot.cycles) / divisor << ' '
+           << std::setw(12) << double(spot.cycles) / divisor / 76 << ' '
+           << std::setw(7) << spot.cycles * 100.0 / total << "  "
+           << name(spot.addr, spot.bank) << endl;
+
+  stringstream folded;
+  profiler->saveFlameGraph(folded, name);
+  cpu.setProfiler(nullptr);
+
+  const FilesystemNode reportFile = argFile(".profile");
+  const string& path = reportFile.getPath();
+  const FilesystemNode foldedFile(path.substr(0, path.find_last_of('.')) + ".folded");
+  try
+  {
+    reportFile.write(report);
+    foldedFile.write(folded);
+  }
+  catch(...)
+  {
+    commandResult << red("unable to save profile");
+    return;
+  }
+
+  commandResult << "profiled " << dec << cycles << " cycles in " << frames
+                << " frames, saved " << reportFile.getShortPath() << " and "
+                << foldedFile.getShortPath();
+  for(size_t i = 0; i < std::min<size_t>(hotSpots.size(), 5); ++i)
+    commandResult << endl << "  " << name(hotSpots[i].addr, hotSpots[i].bank)
+                  << ": " << hotSpots[i].cycles * 100 / total << "%";
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "ram"
 void DebuggerParser::executeRam()
@@ -1738,88 +1830,77 @@ void DebuggerParser::executeRunTo()
   const CartDebug& cartdbg = debugger.cartDebug();
   const CartDebug::DisassemblyList& list = cartdbg.disassembly().list;
 
-  debugger.saveOldState();
-
-  uInt32 count = 0, max_iterations = uInt32(list.size());
+  // Run to all lines which contain the string
+  IntArray addresses;
+  for(const auto& tag: list)
+    if(BSPF::findIgnoreCase(tag.disasm, argStrings[0]) != string::npos)
+      addresses.push_back(tag.address);
 
-  // Create a progress dialog box to show the progress searching through the
-  // disassembly, since this may be a time-consuming operation
-  ostringstream buf;
-  ProgressDialog progress(debugger.baseDialog(), debugger.lfont());
+  if(addresses.empty())
+  {
+    commandResult << argStrings[0] << " not found in disassembly";
+    return;
+  }
 
-  buf << "RunTo searching through " << max_iterations << " disassembled instructions"
-    << progress.ELLIPSIS;
-  progress.setMessage(buf.str());
-  progress.setRange(0, max_iterations, 5);
-  progress.open();
+  debugger.saveOldState();
+  const int cycles = debugger.runTo(addresses);
 
   bool done = false;
-  do {
-    debugger.step(false);
-
-    // Update romlist to point to current PC
-    int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
-    if(pcline >= 0)
-    {
-      const string& next = list[pcline].disasm;
-      done = (BSPF::findIgnoreCase(next, argStrings[0]) != string::npos);
-    }
-    // Update the progress bar
-    progress.incProgress();
-  } while(!done && ++count < max_iterations && !progress.isCancelled());
-
-  progress.close();
+  const int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
+  if(pcline >= 0)
+  {
+    const string& next = list[pcline].disasm;
+    done = (BSPF::findIgnoreCase(next, argStrings[0]) != string::npos);
+  }
 
   if(done)
     commandResult
-      << "found " << argStrings[0] << " in " << dec << count
-      << " disassembled instructions";
+      << "found " << argStrings[0] << " in " << dec << cycles << " cycles";
   else
     commandResult
-      << argStrings[0] << " not found in " << dec << count
-      << " disassembled instructions";
+      << argStrings[0] << " not reached in " << dec << cycles << " cycles";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "runtopc"
 void DebuggerParser::executeRunToPc()
 {
-  const CartDebug& cartdbg = debugger.cartDebug();
-  const CartDebug::DisassemblyList& list = cartdbg.disassembly().list;
-
   debugger.saveOldState();
+  const int cycles = debugger.runTo({ args[0] });
 
-  uInt32 count = 0;
-  bool done = false;
-  // Create a progress dialog box to show the progress searching through the
-  // disassembly, since this may be a time-consuming operation
-  ostringstream buf;
-  ProgressDialog progress(debugger.baseDialog(), debugger.lfont());
+  // Like the breakpoint, this also accepts the mirrors of the address
+  const bool done = ((debugger.cpuDebug().pc() ^ args[0]) & 0x1fff) == 0;
 
-  buf << "        RunTo PC running" << progress.ELLIPSIS << "        ";
-  progress.setMessage(buf.str());
-  progress.setRange(0, 100000, 5);
-  progress.open();
+  if(done)
+    commandResult
+      << "Set PC to $" << Base::HEX4 << args[0] << " in "
+      << dec << cycles << " cycles";
+  else
+    commandResult
+      << "PC $" << Base::HEX4 << args[0] << " not reached in "
+      << dec << cycles << " cycles";
+}
 
-  do {
-    debugger.step(false);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "rununtil"
+void DebuggerParser::executeRunUntil()
+{
+  if(YaccParser::parse(argStrings[0].c_str()) != 0)
+  {
+    commandResult << red("invalid expression");
+    return;
+  }
 
-    // Update romlist to point to current PC
-    int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
-    done = (pcline >= 0) && (list[pcline].address == args[0]);
-    progress.incProgress();
-    ++count;
-  } while(!done && !progress.isCancelled());
-  progress.close();
+  debugger.saveOldState();
+  bool met = false;
+  const int cycles = debugger.runUntil(YaccParser::getResult(), met);
 
-  if(done)
+  if(met)
     commandResult
-      << "Set PC to $" << Base::HEX4 << args[0] << " in "
-      << dec << count << " instructions";
+      << argStrings[0] << " met in " << dec << cycles << " cycles";
   else
     commandResult
-      << "PC $" << Base::HEX4 << args[0] << " not reached or found in "
-      << dec << count << " instructions";
+      << argStrings[0] << " not met in " << dec << cycles << " cycles";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1995,6 +2076,58 @@ void DebuggerParser::executeTrace()
   commandResult << "executed " << dec << debugger.trace() << " cycles";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tracedecode"
+void DebuggerParser::executeTraceDecode()
+{
+  const FilesystemNode trace = argFile(".trace");
+  const FilesystemNode text(trace.getPath() + ".txt");
+
+  try
+  {
+    const uInt64 count = TraceRecorder::decode(trace, text);
+    commandResult << "decoded " << dec << count << " instructions to "
+                  << text.getShortPath();
+  }
+  catch(const runtime_error& e)
+  {
+    commandResult << red(e.what());
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tracerec"
+void DebuggerParser::executeTraceRec()
+{
+  M6502& cpu = debugger.m6502();
+  TraceRecorder* recorder = cpu.traceRecorder();
+
+  if(recorder)
+  {
+    const bool ok = recorder->close();
+    const uInt64 count = recorder->size();
+    const string file = recorder->file().getShortPath();
+    cpu.setTraceRecorder(nullptr);
+
+    if(ok)
+      commandResult << "recorded " << dec << count << " instructions to " << file;
+    else
+      commandResult << red("unable to write trace " + file);
+    return;
+  }
+
+  try
+  {
+    const FilesystemNode file = argFile(".trace");
+    cpu.setTraceRecorder(make_unique<TraceRecorder>(file));
+    commandResult << "recording trace to " << file.getShortPath();
+  }
+  catch(const runtime_error& e)
+  {
+    commandResult << red(e.what());
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "trap"
 void DebuggerParser::executeTrap()
@@ -2328,7 +2461,7 @@ void DebuggerParser::executeZ()
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // List of all commands available to the parser
-std::array<DebuggerParser::Command, 100> DebuggerParser::commands = { {
+std::array<DebuggerParser::Command, 104> DebuggerParser::commands = { {
   {
     "a",
     "Set Accumulator to <value>",
@@ -2937,6 +3070,18 @@ std::array<DebuggerParser::Command, 100> DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executePrint)
   },
 
+  {
+    "profile",
+    "Start/stop profiling CPU cycles [save to file xx]",
+    "Saves the cycles per address (.profile) and per call stack\n"
+    "(.folded, for flame graphs), default file is based on the cart name\n"
+    "Example: profile, profile myprofile",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeProfile)
+  },
+
   {
     "ram",
     "Show ZP RAM, or set address xx to yy1 [yy2 ...]",
@@ -3029,6 +3174,16 @@ std::array<DebuggerParser::Command, 100> DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeRunToPc)
   },
 
+  {
+    "rununtil",
+    "Run until <condition> is true",
+    "Condition can include multiple items, see documentation\nExample: rununtil _scan==100",
+    true,
+    true,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeRunUntil)
+  },
+
   {
     "s",
     "Set Stack Pointer to value xx",
@@ -3193,6 +3348,28 @@ std::array<DebuggerParser::Command, 100> DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeTrace)
   },
 
+  {
+    "tracedecode",
+    "Decode CPU trace [file xx] to text",
+    "Writes the trace as text to the same file with '.txt' appended\n"
+    "Example: tracedecode, tracedecode mytrace",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeTraceDecode)
+  },
+
+  {
+    "tracerec",
+    "Start/stop recording CPU trace [to file xx]",
+    "Records all executed instructions until stopped, default file\n"
+    "is based on the cart name\nExample: tracerec, tracerec mytrace",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeTraceRec)
+  },
+
   {
     "trap",
     "Trap read/write access to address(es) xx [yy]",
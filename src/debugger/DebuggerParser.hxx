@@ -65,6 +65,7 @@ class DebuggerParser
     bool validateArgs(int cmd);
     string eval();
     string saveScriptFile(string file);
+    FilesystemNode argFile(const string& extension) const;
 
   private:
     // Constants for argument processing
@@ -98,7 +99,7 @@ class DebuggerParser
       std::array<Parameters, 10> parms;
       std::function<void (DebuggerParser*)> executor;
     };
-    static std::array<Command, 100> commands;
+    static std::array<Command, 104> commands;
 
     struct Trap
     {
@@ -204,6 +205,7 @@ class DebuggerParser
     void executePCol();
     void executePGfx();
     void executePrint();
+    void executeProfile();
     void executeRam();
     void executeReset();
     void executeRewind();
@@ -213,6 +215,7 @@ class DebuggerParser
     void executeRun();
     void executeRunTo();
     void executeRunToPc();
+    void executeRunUntil();
     void executeS();
     void executeSave();
     void executeSaveAccess();
@@ -229,6 +232,8 @@ class DebuggerParser
     void executeStepwhile();
     void executeTia();
     void executeTrace();
+    void executeTraceDecode();
+    void executeTraceRec();
     void executeTrap();
     void executeTrapif();
     void executeTrapread();
@@ -1247,6 +1247,56 @@ void DiStella::outputBytes(Device::AccessType type)
   addEntry(Device::NONE);*/
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DiStella::disassemble(uInt16 pc, const uInt8* bytes)
+{
+  const Instruction_tag& instr = ourLookup[bytes[0]];
+  const uInt8 d1 = bytes[1];
+  const uInt16 ad = d1 | (bytes[2] << 8);
+
+  ostringstream buf;
+  buf << instr.mnemonic;
+  switch(instr.addr_mode)
+  {
+    case AddressingMode::IMMEDIATE:
+      buf << " #$" << Base::HEX2 << int(d1);
+      break;
+    case AddressingMode::ZERO_PAGE:
+      buf << " $" << Base::HEX2 << int(d1);
+      break;
+    case AddressingMode::ZERO_PAGE_X:
+      buf << " $" << Base::HEX2 << int(d1) << ",x";
+      break;
+    case AddressingMode::ZERO_PAGE_Y:
+      buf << " $" << Base::HEX2 << int(d1) << ",y";
+      break;
+    case AddressingMode::ABSOLUTE:
+      buf << " $" << Base::HEX4 << ad;
+      break;
+    case AddressingMode::ABSOLUTE_X:
+      buf << " $" << Base::HEX4 << ad << ",x";
+      break;
+    case AddressingMode::ABSOLUTE_Y:
+      buf << " $" << Base::HEX4 << ad << ",y";
+      break;
+    case AddressingMode::ABS_INDIRECT:
+      buf << " ($" << Base::HEX4 << ad << ")";
+      break;
+    case AddressingMode::INDIRECT_X:
+      buf << " ($" << Base::HEX2 << int(d1) << ",x)";
+      break;
+    case AddressingMode::INDIRECT_Y:
+      buf << " ($" << Base::HEX2 << int(d1) << "),y";
+      break;
+    case AddressingMode::RELATIVE:
+      buf << " $" << Base::HEX4 << uInt16(pc + 2 + Int8(d1));
+      break;
+    default:
+      break;
+  }
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void DiStella::processDirectives(const CartDebug::DirectiveList& directives)
 {
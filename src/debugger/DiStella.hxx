@@ -72,6 +72,20 @@ class DiStella
              CartDebug::AddrTypeArray& directives,
              CartDebug::ReservedEquates& reserved);
 
+    /**
+      Disassemble a single instruction, without any labels or directives.
+
+      @param pc     The address of the instruction (used for branch targets)
+      @param bytes  The opcode and operand bytes of the instruction
+      @return  The mnemonic and the operand (if any)
+    */
+    static string disassemble(uInt16 pc, const uInt8* bytes);
+
+    /**
+      Answers the length of the instruction with the given opcode, in bytes.
+    */
+    static uInt8 instructionBytes(uInt8 opcode) { return ourLookup[opcode].bytes; }
+
   private:
     /**
     Enumeration of the addressing type (RAM, ROM, RIOT, TIA...)
@@ -18,6 +18,8 @@
 #ifndef EXPRESSION_HXX
 #define EXPRESSION_HXX
 
+class CompiledExpression;
+
 #include "bspf.hxx"
 
 /**
@@ -37,6 +39,12 @@ class Expression
 
     virtual Int32 evaluate() const { return 0; }
 
+    /**
+      Append the bytecode for this node to the given compiled expression.
+      By default, the node is called and evaluated as a tree.
+    */
+    virtual void compile(CompiledExpression& code) const;
+
   protected:
     unique_ptr<Expression> myLHS, myRHS;
 
@@ -0,0 +1,215 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "Base.hxx"
+#include "Cart.hxx"
+#include "DiStella.hxx"
+#include "M6502.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "TraceRecorder.hxx"
+using Common::Base;
+
+namespace {
+  // Signature at the start of each trace file
+  constexpr char SIGNATURE[8] = { 'S', 'T', 'R', 'A', 'C', 'E', '0', '1' };
+
+  // Interval in which the writer checks for new records
+  constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(1);
+
+  // Number of records decoded at once
+  constexpr size_t DECODE_BATCH = 4096;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TraceRecorder::TraceRecorder(const FilesystemNode& file)
+  : myFile{file},
+    myOut{file.getPath(), std::ios::binary},
+    myBuffer(CAPACITY)
+{
+  if(!myOut.write(SIGNATURE, sizeof(SIGNATURE)))
+    throw runtime_error("Unable to create trace file " + file.getShortPath());
+
+  myWriter = std::thread([this]() { drain(); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TraceRecorder::~TraceRecorder()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::record(const M6502& cpu)
+{
+  const System& system = *cpu.mySystem;
+  const TIA& tia = system.tia();
+
+  Record r;
+  r.cycles   = system.cycles();
+  r.pc       = cpu.PC;
+
+  // The TIA is only updated when it is accessed, so project the beam
+  // position from its last update instead of forcing one; this only
+  // misses a frame starting in between
+  uInt32 clock = tia.clocksThisLine() + tia.clocksBehind();
+  r.frame    = uInt16(tia.frameCount());
+  r.scanline = uInt16(tia.scanlines() + clock / TIAConstants::H_CLOCKS);
+  r.clock    = uInt8(clock % TIAConstants::H_CLOCKS);
+  r.bank     = uInt8(system.cart().getBank(cpu.PC));
+  r.a        = cpu.A;
+  r.x        = cpu.X;
+  r.y        = cpu.Y;
+  r.sp       = cpu.SP;
+  r.ps       = cpu.PS();
+
+  // Only read the bytes the CPU is going to read anyway
+  r.bytes[0] = peek(system, cpu.PC);
+  for(uInt8 i = 1; i < DiStella::instructionBytes(r.bytes[0]); ++i)
+    r.bytes[i] = peek(system, cpu.PC + i);
+
+  // If the buffer is full, wait for the writer
+  const uInt64 head = myHead.load(std::memory_order_relaxed);
+  while(head - myTail.load(std::memory_order_acquire) >= CAPACITY)
+    std::this_thread::yield();
+
+  myBuffer[head & (CAPACITY - 1)] = r;
+  myHead.store(head + 1, std::memory_order_release);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TraceRecorder::close()
+{
+  if(!myClosed.exchange(true))
+  {
+    myWriter.join();
+    myOut.close();
+  }
+  return !myOut.fail();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TraceRecorder::peek(const System& system, uInt16 addr)
+{
+  const System::PageAccess& access = system.getPageAccess(addr);
+
+  if(access.directPeekBase)
+    return access.directPeekBase[addr & System::PAGE_MASK];
+
+  // Devices ignore all hotspots while the bank is locked
+  Cartridge& cart = system.cart();
+  const bool locked = cart.bankLocked();
+
+  cart.lockBank();
+  const uInt8 value = access.device->peek(addr);
+  if(!locked)
+    cart.unlockBank();
+
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::drain()
+{
+  for(;;)
+  {
+    // Read the flag first, so that no record added before closing is missed
+    const bool closed = myClosed;
+    const uInt64 tail = myTail.load(std::memory_order_relaxed);
+    const uInt64 head = myHead.load(std::memory_order_acquire);
+
+    if(head == tail)
+    {
+      if(closed)
+        break;
+      std::this_thread::sleep_for(DRAIN_INTERVAL);
+      continue;
+    }
+
+    // Write up to the end of the buffer, the rest is written next time
+    const size_t first = size_t(tail & (CAPACITY - 1));
+    const size_t count = size_t(std::min<uInt64>(head - tail, CAPACITY - first));
+
+    myOut.write(reinterpret_cast<const char*>(&myBuffer[first]),
+                std::streamsize(count * sizeof(Record)));
+    myTail.store(tail + count, std::memory_order_release);
+  }
+  myOut.flush();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 TraceRecorder::decode(const FilesystemNode& in, const FilesystemNode& out)
+{
+  std::ifstream trace(in.getPath(), std::ios::binary);
+  char signature[sizeof(SIGNATURE)];
+
+  if(!trace.read(signature, sizeof(signature)) ||
+     !std::equal(signature, signature + sizeof(signature), SIGNATURE))
+    throw runtime_error(in.getShortPath() + " is not a trace file");
+
+  std::ofstream text(out.getPath());
+  if(!text)
+    throw runtime_error("Unable to create " + out.getShortPath());
+
+  text << "frame scan clk bank pc    bytes     instruction     "
+          "A  X  Y  SP PS     cycles\n";
+
+  vector<Record> records(DECODE_BATCH);
+  uInt64 count = 0;
+
+  while(trace)
+  {
+    trace.read(reinterpret_cast<char*>(records.data()),
+               std::streamsize(records.size() * sizeof(Record)));
+    const size_t n = size_t(trace.gcount()) / sizeof(Record);
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      const Record& r = records[i];
+      const uInt8 length = DiStella::instructionBytes(r.bytes[0]);
+
+      ostringstream bytes;
+      for(uInt8 b = 0; b < length; ++b)
+        bytes << Base::HEX2 << int(r.bytes[b]) << ' ';
+
+      text << std::dec << std::setfill(' ')
+           << std::setw(5) << r.frame << ' '
+           << std::setw(4) << r.scanline << ' '
+           << std::setw(3) << int(r.clock) << ' '
+           << std::setw(4) << int(r.bank) << ' '
+           << Base::HEX4 << r.pc << "  "
+           << std::left << std::setfill(' ')
+           << std::setw(10) << bytes.str()
+           << std::setw(16) << DiStella::disassemble(r.pc, r.bytes.data())
+           << std::right
+           << Base::HEX2 << int(r.a) << ' '
+           << Base::HEX2 << int(r.x) << ' '
+           << Base::HEX2 << int(r.y) << ' '
+           << Base::HEX2 << int(r.sp) << ' '
+           << Base::HEX2 << int(r.ps) << ' '
+           << std::dec << std::setfill(' ') << std::setw(10) << r.cycles << '\n';
+    }
+    count += n;
+  }
+
+  if(!text.flush())
+    throw runtime_error("Unable to write " + out.getShortPath());
+
+  return count;
+}
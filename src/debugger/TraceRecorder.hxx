@@ -0,0 +1,136 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TRACE_RECORDER_HXX
+#define TRACE_RECORDER_HXX
+
+class M6502;
+class System;
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "FSNode.hxx"
+#include "bspf.hxx"
+
+/**
+  Records a binary trace of all instructions executed by the CPU.
+
+  Before each instruction, the CPU passes its state to the recorder, which
+  stores it as a fixed-size record in a lock-free ring buffer.  A background
+  thread drains the buffer to disk.  Recording only reads the state of the
+  system (like the debugger does), so the emulation runs exactly as it
+  would without it.
+
+  The trace file starts with an 8 byte signature, followed by the records
+  in host byte order.  It can be converted to text with 'decode'.
+
+  @author  Stella Team
+*/
+class TraceRecorder
+{
+  public:
+    // The state of the system at the start of an instruction
+    struct Record {
+      uInt64 cycles{0};         // system cycles
+      uInt16 pc{0};
+      uInt16 frame{0};          // the lower 16 bits of the frame number
+      uInt16 scanline{0};
+      uInt8 clock{0};           // color clock in the scanline
+      uInt8 bank{0};
+      uInt8 a{0}, x{0}, y{0}, sp{0}, ps{0};
+      std::array<uInt8, 3> bytes{0};  // opcode and operands
+    };
+    static_assert(sizeof(Record) == 24, "unexpected trace record size");
+
+  public:
+    /**
+      Create a recorder which writes to the given file.
+
+      Throws a runtime_error if the file cannot be created.
+    */
+    explicit TraceRecorder(const FilesystemNode& file);
+    ~TraceRecorder();
+
+    /**
+      Record the instruction which the given CPU is about to execute.
+      This may only be called by the emulation thread.
+    */
+    void record(const M6502& cpu);
+
+    /**
+      Write all outstanding records and close the file.  Nothing may be
+      recorded afterwards.
+
+      @return  False if the trace could not be written completely
+    */
+    bool close();
+
+    /**
+      Answers the number of instructions recorded so far.
+    */
+    uInt64 size() const { return myHead; }
+
+    /**
+      Answers the file the trace is written to.
+    */
+    const FilesystemNode& file() const { return myFile; }
+
+    /**
+      Convert a binary trace into a text file, one instruction per line.
+
+      Throws a runtime_error if the trace cannot be read or the text file
+      cannot be written.
+
+      @param in   The binary trace file
+      @param out  The text file to create
+      @return  The number of decoded instructions
+    */
+    static uInt64 decode(const FilesystemNode& in, const FilesystemNode& out);
+
+  private:
+    // Read a byte without triggering hotspots or updating the data bus
+    static uInt8 peek(const System& system, uInt16 addr);
+
+    // Write the buffer to the file, until the recorder is closed
+    void drain();
+
+  private:
+    // Number of records in the ring buffer (must be a power of two)
+    static constexpr size_t CAPACITY = 1 << 18;
+
+    FilesystemNode myFile;
+    std::ofstream myOut;
+
+    vector<Record> myBuffer;
+    // Records are added at 'myHead' and written from 'myTail'
+    std::atomic<uInt64> myHead{0}, myTail{0};
+    std::atomic<bool> myClosed{false};
+
+    std::thread myWriter;
+
+  private:
+    // Following constructors and assignment operators not supported
+    TraceRecorder() = delete;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder(TraceRecorder&&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(TraceRecorder&&) = delete;
+};
+
+#endif
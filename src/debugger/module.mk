@@ -5,10 +5,13 @@ MODULE_OBJS := \
         src/debugger/Debugger.o \
         src/debugger/DebuggerParser.o \
         src/debugger/CartDebug.o \
+        src/debugger/CompiledExpression.o \
         src/debugger/CpuDebug.o \
+        src/debugger/CpuProfiler.o \
         src/debugger/DiStella.o \
         src/debugger/RiotDebug.o \
-        src/debugger/TIADebug.o
+        src/debugger/TIADebug.o \
+        src/debugger/TraceRecorder.o
 
 MODULE_DIRS += \
         src/debugger
@@ -0,0 +1,296 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#include "BatchRunner.hxx"
+#include "Bankswitch.hxx"
+#include "FSNode.hxx"
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "MD5.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameManager.hxx"
+#include "FrameLayoutDetector.hxx"
+#include "System.hxx"
+#include "Joystick.hxx"
+#include "Random.hxx"
+#include "DispatchResult.hxx"
+#include "Logger.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+namespace {
+  static constexpr uInt32 FRAMES_DEFAULT = 3600;
+  static constexpr uInt32 LAYOUT_DETECTION_FRAMES = 60;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BatchRunner::BatchRunner(int argc, char* argv[])
+{
+  for (int i = 2; i < argc; i++) {
+    const string arg = argv[i];
+
+    if (arg[0] == '-' && i + 1 < argc) {
+      const string value = argv[++i];
+
+      if (arg == "-jobs")
+        myJobs = std::max(BSPF::stringToInt(value), 0);
+      else if (arg == "-frames")
+        myFrameBudget = std::max(BSPF::stringToInt(value), 0);
+      else if (arg == "-cycles")
+        myCycleBudget = std::strtoull(value.c_str(), nullptr, 10);
+      else if (arg == "-out")
+        myOutFile = value;
+      else
+        cerr << "WARNING: ignoring unknown batch option " << arg << endl;
+    }
+    else
+      addRoms(arg);
+  }
+
+  if (myJobs == 0)
+    myJobs = std::max(std::thread::hardware_concurrency(), 1U);
+  if (myFrameBudget == 0 && myCycleBudget == 0)
+    myFrameBudget = FRAMES_DEFAULT;
+
+  myJobs = std::min<uInt32>(myJobs, uInt32(std::max<size_t>(myResults.size(), 1)));
+
+  // Keep per-ROM chatter out of the results, which may go to cout
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+  Logger::instance().setConsoleStream(cerr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::addRoms(const string& path)
+{
+  FilesystemNode node(path);
+
+  if (node.isDirectory()) {
+    FSList files;
+    files.reserve(2048);
+    node.getChildren(files, FilesystemNode::ListMode::All,
+      [](const FilesystemNode& child) { return Bankswitch::isValidRomName(child); },
+      true, false);
+
+    // Keep the output stable, independent of the filesystem order
+    std::sort(files.begin(), files.end(),
+      [](const FilesystemNode& a, const FilesystemNode& b) {
+        return a.getPath() < b.getPath();
+      });
+
+    for (const auto& file: files) {
+      BatchResult result;
+      result.romFile = file.getPath();
+      myResults.push_back(result);
+    }
+  }
+  else {
+    BatchResult result;
+    result.romFile = path;
+    myResults.push_back(result);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchRunner::run()
+{
+  cerr << "Running " << myResults.size() << " ROM(s) on " << myJobs
+       << " thread(s)..." << endl;
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  vector<std::thread> workers;
+  workers.reserve(myJobs);
+  for (uInt32 i = 0; i < myJobs; ++i)
+    workers.emplace_back([this]() { work(); });
+
+  for (auto& worker: workers)
+    worker.join();
+
+  double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+  cerr << "finished in " << realtimeUsed << " seconds" << endl;
+
+  if (myOutFile.empty())
+    writeResults(cout);
+  else {
+    std::ofstream out(myOutFile);
+    if (!out) {
+      cerr << "ERROR: unable to write " << myOutFile << endl;
+      return false;
+    }
+    writeResults(out);
+  }
+
+  return std::all_of(myResults.begin(), myResults.end(),
+    [](const BatchResult& result) { return result.ok; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::work()
+{
+  for (size_t job = myNextJob++; job < myResults.size(); job = myNextJob++) {
+    BatchResult& result = myResults[job];
+
+    try {
+      runOne(result);
+    }
+    // A bad ROM must only fail its own job, not the whole run
+    catch (const std::exception& e) {
+      result.ok = false;
+      result.error = e.what();
+    }
+    catch (...) {
+      result.ok = false;
+      result.error = "unknown error";
+    }
+
+    std::lock_guard<std::mutex> lock(myProgressMutex);
+
+    cerr << "[" << ++myFinishedJobs << "/" << myResults.size() << "] "
+         << result.romFile << (result.ok ? "" : " FAILED: " + result.error) << endl;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::runOne(BatchResult& result) const
+{
+  FilesystemNode imageFile(result.romFile);
+
+  if (!imageFile.isFile()) {
+    result.error = "not a ROM image";
+    return;
+  }
+
+  ByteBuffer image;
+  size_t size = imageFile.read(image);
+  if (size == 0) {
+    result.error = "unable to read ROM image";
+    return;
+  }
+
+  // Every worker gets its own settings, since these are not thread-safe
+  Settings settings;
+  settings.setValue("fastscbios", true);
+  Properties props;
+
+  result.md5 = MD5::hash(image, size);
+  unique_ptr<Cartridge> cartridge = CartCreator::create(
+      imageFile, image, size, result.md5, "", settings);
+
+  if (!cartridge) {
+    result.error = "unable to determine cartridge type";
+    return;
+  }
+  result.type = cartridge->detectedType().empty()
+    ? cartridge->name() : cartridge->detectedType();
+
+  IO consoleIO;
+  Random rng(0);
+  Event event;
+
+  M6502 cpu(settings);
+  M6532 riot(consoleIO, settings);
+  TIA tia(consoleIO, []() { return ConsoleTiming::ntsc; }, settings);
+  System system(rng, cpu, riot, tia, *cartridge);
+
+  consoleIO.myLeftControl = make_unique<Joystick>(Controller::Jack::Left, event, system);
+  consoleIO.myRightControl = make_unique<Joystick>(Controller::Jack::Right, event, system);
+  consoleIO.mySwitches = make_unique<Switches>(event, props, settings);
+
+  tia.bindToControllers();
+  cartridge->setStartBankFromPropsFunc([]() { return -1; });
+  system.initialize();
+
+  FrameLayoutDetector frameLayoutDetector;
+  tia.setFrameManager(&frameLayoutDetector);
+  system.reset();
+
+  for(uInt32 i = 0; i < LAYOUT_DETECTION_FRAMES; ++i) tia.update();
+
+  FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
+  result.layout = frameLayout == FrameLayout::pal ? "PAL" : "NTSC";
+
+  FrameManager frameManager;
+  tia.setFrameManager(&frameManager);
+  tia.setLayout(frameLayout);
+
+  system.reset();
+
+  const uInt32 startFrame = frameManager.frameCount();
+  const uInt64 cyclesTarget = myCycleBudget > 0 ? myCycleBudget : ~uInt64(0);
+  const uInt32 framesTarget = myFrameBudget > 0 ? myFrameBudget : ~uInt32(0);
+
+  DispatchResult dispatchResult;
+  dispatchResult.setOk(0);
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  while (result.cycles < cyclesTarget && result.frames < framesTarget &&
+         dispatchResult.getStatus() == DispatchResult::Status::ok) {
+    tia.update(dispatchResult);
+    result.cycles += dispatchResult.getCycles();
+    result.frames = frameManager.frameCount() - startFrame;
+
+    if (tia.newFramePending()) tia.renderToFrameBuffer();
+  }
+
+  result.realtime = duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+  result.ramHash = MD5::hash(riot.getRAM(), 128);
+
+  if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
+    result.error = "emulation failed after " + std::to_string(result.cycles) + " cycles";
+    return;
+  }
+
+  result.ok = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::writeResults(ostream& out) const
+{
+  json results = json::array();
+
+  for (const auto& result: myResults) {
+    json entry = json::object();
+
+    entry["file"] = result.romFile;
+    entry["ok"] = result.ok;
+    if (!result.error.empty()) entry["error"] = result.error;
+    if (!result.md5.empty()) entry["md5"] = result.md5;
+    if (!result.type.empty()) entry["type"] = result.type;
+    if (!result.layout.empty()) entry["layout"] = result.layout;
+    if (!result.ramHash.empty()) entry["ramHash"] = result.ramHash;
+    entry["frames"] = result.frames;
+    entry["cycles"] = result.cycles;
+    entry["seconds"] = result.realtime;
+    entry["cyclesPerSecond"] = result.realtime > 0
+      ? static_cast<double>(result.cycles) / result.realtime : 0.0;
+
+    results.push_back(entry);
+  }
+
+  out << results.dump(2) << endl;
+}
@@ -0,0 +1,128 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef BATCH_RUNNER
+#define BATCH_RUNNER
+
+#include <atomic>
+#include <mutex>
+
+#include "bspf.hxx"
+#include "Control.hxx"
+#include "Switches.hxx"
+#include "Settings.hxx"
+#include "ConsoleIO.hxx"
+#include "Props.hxx"
+
+/**
+  Headless batch mode, invoked as
+
+    stella -batch [-jobs N] [-frames N] [-cycles N] [-out FILE] ROM|DIR ...
+
+  Every ROM (directories are searched recursively for valid ROM names) is
+  emulated on a bare System/M6502/M6532/TIA/Cartridge stack, exactly like
+  the profiling runner does, but the list is sharded across a pool of worker
+  threads, each with its own independent console.  Every ROM runs until
+  either the frame or the cycle budget is exhausted.
+
+  The results are written as a JSON array (one object per ROM, in the order
+  the ROMs were given) to stdout or to the file given with '-out'.
+
+  @author  Stella Team
+*/
+class BatchRunner
+{
+  public:
+    BatchRunner(int argc, char* argv[]);
+
+    /**
+      Run all jobs.
+
+      @return  True if every ROM could be emulated successfully
+    */
+    bool run();
+
+  private:
+    struct BatchResult {
+      string romFile;
+      string md5;
+      string type;
+      string layout;
+      string ramHash;
+      string error;
+      uInt64 cycles{0};
+      uInt32 frames{0};
+      double realtime{0};
+      bool ok{false};
+    };
+
+    struct IO: public ConsoleIO {
+      Controller& leftController() const override { return *myLeftControl; }
+      Controller& rightController() const override { return *myRightControl; }
+      Switches& switches() const override { return *mySwitches; }
+
+      unique_ptr<Controller> myLeftControl;
+      unique_ptr<Controller> myRightControl;
+      unique_ptr<Switches> mySwitches;
+    };
+
+  private:
+    /**
+      Add the given ROM, or all valid ROMs below the given directory.
+    */
+    void addRoms(const string& path);
+
+    /**
+      Worker thread body; picks jobs until the list is exhausted.
+    */
+    void work();
+
+    /**
+      Emulate a single ROM on a fresh console.
+    */
+    void runOne(BatchResult& result) const;
+
+    /**
+      Write all results as JSON to the given stream.
+    */
+    void writeResults(ostream& out) const;
+
+  private:
+    vector<BatchResult> myResults;
+
+    // Index of the next job to be picked up by a worker
+    std::atomic<size_t> myNextJob{0};
+
+    // Number of finished jobs, and a lock for the progress output
+    size_t myFinishedJobs{0};
+    std::mutex myProgressMutex;
+
+    uInt32 myJobs{0};
+    uInt32 myFrameBudget{0};
+    uInt64 myCycleBudget{0};
+    string myOutFile;
+
+  private:
+    // Following constructors and assignment operators not supported
+    BatchRunner() = delete;
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner(BatchRunner&&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+    BatchRunner& operator=(BatchRunner&&) = delete;
+};
+
+#endif // BATCH_RUNNER
@@ -103,7 +103,8 @@ uInt8 Cartridge::peekRAM(uInt8& dest, uInt16 address)
   if(!bankLocked() && !mySystem->autodetectMode())
   {
     // Record access here; final determination will happen in ::pokeRAM()
-    myRamReadAccesses.push_back(address);
+    if(myTrackRAMAccesses)
+      myRamReadAccesses.push_back(address);
     dest = value;
   }
 #else
@@ -117,12 +118,15 @@ uInt8 Cartridge::peekRAM(uInt8& dest, uInt16 address)
 void Cartridge::pokeRAM(uInt8& dest, uInt16 address, uInt8 value)
 {
 #ifdef DEBUGGER_SUPPORT
-  for(auto i = myRamReadAccesses.begin(); i != myRamReadAccesses.end(); ++i)
+  if(myTrackRAMAccesses)
   {
-    if(*i == address)
+    for(auto i = myRamReadAccesses.begin(); i != myRamReadAccesses.end(); ++i)
     {
-      myRamReadAccesses.erase(i);
-      break;
+      if(*i == address)
+      {
+        myRamReadAccesses.erase(i);
+        break;
+      }
     }
   }
 #endif
@@ -158,6 +158,19 @@ class Cartridge : public Device
     */
     uInt16 getIllegalRAMWriteAccess() const { return myRamWriteAccess; }
 
+    /**
+      Set whether read accesses to cart RAM are recorded.  Recording is
+      only needed when the CPU checks for illegal accesses after each
+      instruction; otherwise the accesses would pile up.
+
+      @param track  Whether to record read accesses
+    */
+    void trackRAMAccesses(bool track) {
+      myTrackRAMAccesses = track;
+      if(!track)
+        myRamReadAccesses.clear();
+    }
+
     /**
       Query the access counters
 
@@ -417,6 +430,9 @@ class Cartridge : public Device
     // access.
     ShortArray myRamReadAccesses;
 
+    // Whether read accesses are recorded in myRamReadAccesses
+    bool myTrackRAMAccesses{false};
+
     // Following constructors and assignment operators not supported
     Cartridge() = delete;
     Cartridge(const Cartridge&) = delete;
@@ -88,7 +88,7 @@ void CartridgeBUS::reset()
 
   // Update cycles to the current system cycles
   myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  myMusicClocks.reset();
 
   setInitialState();
 
@@ -147,9 +147,7 @@ inline void CartridgeBUS::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of BUS OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  uInt32 wholeClocks = myMusicClocks.convert(cycles);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -575,8 +573,9 @@ bool CartridgeBUS::save(Serializer& out) const
 
     // Save cycles and clocks
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    myMusicClocks.save(out);
     out.putLong(myARMCycles);
+    myThumbEmulator->save(out);
 
     // Audio info
     out.putIntArray(myMusicCounters.data(), myMusicCounters.size());
@@ -616,8 +615,9 @@ bool CartridgeBUS::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myMusicClocks.load(in);
     myARMCycles = in.getLong();
+    myThumbEmulator->load(in);
 
     // Audio info
     in.getIntArray(myMusicCounters.data(), myMusicCounters.size());
@@ -26,6 +26,7 @@ class Thumbulator;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "ClockConverter.hxx"
 
 /**
   Cartridge class used for BUS.
@@ -283,8 +284,8 @@ class CartridgeBUS : public Cartridge
     // The music waveform sizes
     std::array<uInt8, 3> myMusicWaveformSize{0};
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks{0.0};
+    // Converts 6507 cycles into BUS music OSC clocks (20 kHz)
+    ClockConverter myMusicClocks{ClockConverter::fromCpuCycles(20000)};
 
     // Controls mode, lower nybble sets Fast Fetch, upper nybble sets audio
     // -0 = Bus Stuffing ON
@@ -123,7 +123,7 @@ void CartridgeCDF::reset()
   initializeStartBank(isCDFJplus() ? 0 : 6);
 
   myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  myMusicClocks.reset();
 
   setInitialState();
 
@@ -175,9 +175,7 @@ inline void CartridgeCDF::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of CDF OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  uInt32 wholeClocks = myMusicClocks.convert(cycles);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -558,8 +556,9 @@ bool CartridgeCDF::save(Serializer& out) const
 
     // Save cycles and clocks
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    myMusicClocks.save(out);
     out.putLong(myARMCycles);
+    myThumbEmulator->save(out);
   }
   catch(...)
   {
@@ -598,8 +597,9 @@ bool CartridgeCDF::load(Serializer& in)
 
     // Get cycles and clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myMusicClocks.load(in);
     myARMCycles = in.getLong();
+    myThumbEmulator->load(in);
   }
   catch(...)
   {
@@ -23,6 +23,7 @@ class Thumbulator;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "ClockConverter.hxx"
 
 /**
   Cartridge class used for CDF/CDFJ/CDFJ+.
@@ -323,8 +324,8 @@ class CartridgeCDF : public Cartridge
     // The music waveform sizes
     std::array<uInt8, 3> myMusicWaveformSize{0};
 
-    // Fractional CDF music, OSC clocks unused during the last update
-    double myFractionalClocks{0.0};
+    // Converts 6507 cycles into CDF music OSC clocks (20 kHz)
+    ClockConverter myMusicClocks{ClockConverter::fromCpuCycles(20000)};
 
     // Controls mode, lower nybble sets Fast Fetch, upper nybble sets audio
     // -0 = Fast Fetch ON
@@ -58,7 +58,7 @@ void CartridgeCTY::reset()
   myRamAccessTimeout = 0;
 
   myAudioCycles = 0;
-  myFractionalClocks = 0.0;
+  myMusicClocks.reset();
 
   // Upon reset we switch to the startup bank
   bank(startBank());
@@ -299,7 +299,7 @@ bool CartridgeCTY::save(Serializer& out) const
     out.putBool(myLDAimmediate);
     out.putInt(myRandomNumber);
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    myMusicClocks.save(out);
     out.putIntArray(myMusicCounters.data(), myMusicCounters.size());
     out.putIntArray(myMusicFrequencies.data(), myMusicFrequencies.size());
     out.putLong(myFrequencyImage - myTuneData.data()); // FIXME - storing pointer diff!
@@ -327,7 +327,7 @@ bool CartridgeCTY::load(Serializer& in)
     myLDAimmediate = in.getBool();
     myRandomNumber = in.getInt();
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myMusicClocks.load(in);
     in.getIntArray(myMusicCounters.data(), myMusicCounters.size());
     in.getIntArray(myMusicFrequencies.data(), myMusicFrequencies.size());
     myFrequencyImage = myTuneData.data() + in.getLong();
@@ -573,9 +573,7 @@ inline void CartridgeCTY::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of CTY OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  uInt32 wholeClocks = myMusicClocks.convert(cycles);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -22,6 +22,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "ClockConverter.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartCTYWidget.hxx"
 #endif
@@ -306,8 +307,8 @@ class CartridgeCTY : public Cartridge
     // System cycle count from when the last update to music data fetchers occurred
     uInt64 myAudioCycles{0};
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks{0.0};
+    // Converts 6507 cycles into CTY music OSC clocks (20 kHz)
+    ClockConverter myMusicClocks{ClockConverter::fromCpuCycles(20000)};
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset{0};
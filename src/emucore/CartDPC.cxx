@@ -34,8 +34,7 @@ void CartridgeDPC::reset()
   CartridgeEnhanced::reset();
 
   myAudioCycles = 0;
-  myFractionalClocks = 0.0;
-  myDpcPitch = mySettings.getInt(AudioSettings::SETTING_DPC_PITCH);
+  setDpcPitch(mySettings.getInt(AudioSettings::SETTING_DPC_PITCH));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -82,9 +81,7 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((myDpcPitch * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  uInt32 wholeClocks = myMusicClocks.convert(cycles);
 
   if(wholeClocks <= 0)
     return;
@@ -363,7 +360,7 @@ bool CartridgeDPC::save(Serializer& out) const
     out.putByte(myRandomNumber);
 
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    myMusicClocks.save(out);
   }
   catch(...)
   {
@@ -403,7 +400,7 @@ bool CartridgeDPC::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myMusicClocks.load(in);
   }
   catch(...)
   {
@@ -19,6 +19,7 @@
 #define CARTRIDGE_DPC_HXX
 
 #include "CartF8.hxx"
+#include "ClockConverter.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartDPCWidget.hxx"
 #endif
@@ -103,7 +104,9 @@ class CartridgeDPC : public CartridgeF8
 
       @param pitch  The new pitch value
     */
-    void setDpcPitch(double pitch) { myDpcPitch = pitch; }
+    void setDpcPitch(double pitch) {
+      myMusicClocks = ClockConverter::fromCpuCycles(uInt64(pitch));
+    }
 
   #ifdef DEBUGGER_SUPPORT
     /**
@@ -171,11 +174,8 @@ class CartridgeDPC : public CartridgeF8
     // System cycle count from when the last update to music data fetchers occurred
     uInt64 myAudioCycles{0};
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks{0.0};
-
-    // DPC pitch
-    double myDpcPitch{0.0};
+    // Converts 6507 cycles into music OSC clocks, at the DPC pitch
+    ClockConverter myMusicClocks;
 
   private:
     // Following constructors and assignment operators not supported
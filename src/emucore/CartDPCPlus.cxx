@@ -117,7 +117,7 @@ void CartridgeDPCPlus::setInitialState()
   // Initialize various other parameters
   myFastFetch = myLDAimmediate = false;
   myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  myMusicClocks.reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -165,9 +165,7 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of DPC+ OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  uInt32 wholeClocks = myMusicClocks.convert(cycles);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -706,10 +704,11 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 
     // Get system cycles and fractional clocks
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    myMusicClocks.save(out);
 
     // Clock info for Thumbulator
     out.putLong(myARMCycles);
+    myThumbEmulator->save(out);
   }
   catch(...)
   {
@@ -767,10 +766,11 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
     // Get audio cycles and fractional clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myMusicClocks.load(in);
 
     // Clock info for Thumbulator
     myARMCycles = in.getLong();
+    myThumbEmulator->load(in);
   }
   catch(...)
   {
@@ -27,6 +27,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "ClockConverter.hxx"
 
 /**
   Cartridge class used for DPC+, derived from Pitfall II.  There are six 4K
@@ -291,8 +292,8 @@ class CartridgeDPCPlus : public Cartridge
     // System cycle count when the last Thumbulator::run() occurred
     uInt64 myARMCycles{0};
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks{0.0};
+    // Converts 6507 cycles into DPC+ music OSC clocks (20 kHz)
+    ClockConverter myMusicClocks{ClockConverter::fromCpuCycles(20000)};
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset{0};
@@ -20,9 +20,206 @@
 
 #include "CartDetector.hxx"
 
+namespace {
+  /**
+    All byte signatures the heuristics look for.  These are found in a
+    single pass over the image (see CartDetector::Signatures), so any new
+    signature must be added here and to 'patterns()' below.
+  */
+  enum Signature: uInt8 {
+    STA_1FF9, STA_FFF9,
+    ARM_LOADER_1, ARM_LOADER_2,
+    LDA_0800, LDA_0840, BIT_0800, NOP_0800_JMP, NOP_0FFF_JMP,
+    STA_3E, STA_3F,
+    STRING_3EX, STRING_TJ3E, STRING_BUS, STRING_CDF, STRING_PLUSCDFJ,
+    STRING_LENIN, STRING_DPCP, STRING_MDMC,
+    STA_F3FF_X, STA_F400_Y,
+    STA_1FE0, STA_5FE0, STA_FFE9, NOP_1FE0, LDA_1FE0, LDA_FFE9, LDA_FFED,
+    LDA_BFF3,
+    LDA_FFE2, LDA_FFE5, LDA_1FE5, LDA_1FE7, NOP_1FE7, STA_FFE7, STA_1FE7,
+    LDA_FFE4, LDA_FFE6,
+    NOP_FFE0, LDA_FFE0,
+    STA_1FF8_LSR_LSR_STA, STA_FFF8_STA_FFFC, STY_FFF9_LDA_FFFC,
+    JSR_D000_DEC_C5, JSR_F8C3_LDA_82, BNE_JSR_FE73, JSR_F000_STY_D6,
+    LDA_0800_X,
+    STA_82_Y_JMP_FFFC,
+    STA_0240, LDA_0240, LDA_021F_X, BIT_02C0, STA_02C0, LDA_02C0, BIT_0FC0,
+    LDA_39_JMP,
+    LDA_080D, LDA_081D, LDA_082D, NOP_080D, NOP_081D, NOP_082D,
+    NUM_SIGNATURES
+  };
+
+  struct Pattern {
+    std::array<uInt8, 8> bytes{0};
+    uInt32 size{0};
+  };
+
+  using PatternList = std::array<Pattern, NUM_SIGNATURES>;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  const PatternList& patterns()
+  {
+    static const PatternList list = []() {
+      PatternList p;
+      const auto set = [&p](Signature sig, std::initializer_list<uInt8> bytes) {
+        std::copy(bytes.begin(), bytes.end(), p[sig].bytes.begin());
+        p[sig].size = uInt32(bytes.size());
+      };
+
+      set(STA_1FF9, { 0x8D, 0xF9, 0x1F });
+      set(STA_FFF9, { 0x8D, 0xF9, 0xFF });
+      // ARM 'loader' patterns
+      set(ARM_LOADER_1, { 0xA0, 0xC1, 0x1F, 0xE0 });
+      set(ARM_LOADER_2, { 0x00, 0x80, 0x02, 0xE0 });
+      set(LDA_0800, { 0xAD, 0x00, 0x08 });
+      set(LDA_0840, { 0xAD, 0x40, 0x08 });
+      set(BIT_0800, { 0x2C, 0x00, 0x08 });
+      set(NOP_0800_JMP, { 0x0C, 0x00, 0x08, 0x4C });  // NOP $0800; JMP ...
+      set(NOP_0FFF_JMP, { 0x0C, 0xFF, 0x0F, 0x4C });  // NOP $0FFF; JMP ...
+      set(STA_3E, { 0x85, 0x3E });
+      set(STA_3F, { 0x85, 0x3F });
+      set(STRING_3EX, { '3', 'E', 'X' });
+      set(STRING_TJ3E, { 'T', 'J', '3', 'E' });
+      set(STRING_BUS, { 'B', 'U', 'S' });
+      set(STRING_CDF, { 'C', 'D', 'F' });
+      set(STRING_PLUSCDFJ, { 'P', 'L', 'U', 'S', 'C', 'D', 'F', 'J' });
+      set(STRING_LENIN, { 'L', 'E', 'N', 'I', 'N' });
+      set(STRING_DPCP, { 'D', 'P', 'C', '+' });
+      set(STRING_MDMC, { 'M', 'D', 'M', 'C' });
+      set(STA_F3FF_X, { 0x9D, 0xFF, 0xF3 });  // STA $F3FF.X
+      set(STA_F400_Y, { 0x99, 0x00, 0xF4 });  // STA $F400.Y
+      set(STA_1FE0, { 0x8D, 0xE0, 0x1F });
+      set(STA_5FE0, { 0x8D, 0xE0, 0x5F });
+      set(STA_FFE9, { 0x8D, 0xE9, 0xFF });
+      set(NOP_1FE0, { 0x0C, 0xE0, 0x1F });
+      set(LDA_1FE0, { 0xAD, 0xE0, 0x1F });
+      set(LDA_FFE9, { 0xAD, 0xE9, 0xFF });
+      set(LDA_FFED, { 0xAD, 0xED, 0xFF });
+      set(LDA_BFF3, { 0xAD, 0xF3, 0xBF });
+      set(LDA_FFE2, { 0xAD, 0xE2, 0xFF });
+      set(LDA_FFE5, { 0xAD, 0xE5, 0xFF });
+      set(LDA_1FE5, { 0xAD, 0xE5, 0x1F });
+      set(LDA_1FE7, { 0xAD, 0xE7, 0x1F });
+      set(NOP_1FE7, { 0x0C, 0xE7, 0x1F });
+      set(STA_FFE7, { 0x8D, 0xE7, 0xFF });
+      set(STA_1FE7, { 0x8D, 0xE7, 0x1F });
+      set(LDA_FFE4, { 0xAD, 0xE4, 0xFF });
+      set(LDA_FFE6, { 0xAD, 0xE6, 0xFF });
+      set(NOP_FFE0, { 0x0C, 0xE0, 0xFF });
+      set(LDA_FFE0, { 0xAD, 0xE0, 0xFF });
+      set(STA_1FF8_LSR_LSR_STA, { 0x8D, 0xF8, 0x1F, 0x4A, 0x4A, 0x8D });
+      set(STA_FFF8_STA_FFFC, { 0x8D, 0xF8, 0xFF, 0x8D, 0xFC, 0xFF });
+      set(STY_FFF9_LDA_FFFC, { 0x8C, 0xF9, 0xFF, 0xAD, 0xFC, 0xFF });
+      set(JSR_D000_DEC_C5, { 0x20, 0x00, 0xD0, 0xC6, 0xC5 });
+      set(JSR_F8C3_LDA_82, { 0x20, 0xC3, 0xF8, 0xA5, 0x82 });
+      set(BNE_JSR_FE73, { 0xD0, 0xFB, 0x20, 0x73, 0xFE });    // BNE $FB; JSR $FE73
+      set(JSR_F000_STY_D6, { 0x20, 0x00, 0xF0, 0x84, 0xD6 });
+      set(LDA_0800_X, { 0xBD, 0x00, 0x08 });
+      set(STA_82_Y_JMP_FFFC, { 0x91, 0x82, 0x6C, 0xFC, 0xFF });  // STA ($82),Y; JMP ($FFFC)
+      set(STA_0240, { 0x8D, 0x40, 0x02 });
+      set(LDA_0240, { 0xAD, 0x40, 0x02 });
+      set(LDA_021F_X, { 0xBD, 0x1F, 0x02 });
+      set(BIT_02C0, { 0x2C, 0xC0, 0x02 });
+      set(STA_02C0, { 0x8D, 0xC0, 0x02 });
+      set(LDA_02C0, { 0xAD, 0xC0, 0x02 });
+      set(BIT_0FC0, { 0x2C, 0xC0, 0x0F });
+      set(LDA_39_JMP, { 0xA5, 0x39, 0x4C });
+      set(LDA_080D, { 0xAD, 0x0D, 0x08 });
+      set(LDA_081D, { 0xAD, 0x1D, 0x08 });
+      set(LDA_082D, { 0xAD, 0x2D, 0x08 });
+      set(NOP_080D, { 0x0C, 0x0D, 0x08 });
+      set(NOP_081D, { 0x0C, 0x1D, 0x08 });
+      set(NOP_082D, { 0x0C, 0x2D, 0x08 });
+
+      return p;
+    }();
+
+    return list;
+  }
+
+  /**
+    All patterns, grouped by their first two bytes.  A bitmap of the
+    prefixes in use rejects almost every position of an image with a
+    single lookup.
+  */
+  struct PrefixIndex {
+    std::array<uInt64, 65536 / 64> used{0};
+    std::array<uInt16, 65536 + 1> first{0};  // into 'patterns'
+    std::array<Signature, NUM_SIGNATURES> patterns;
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  inline uInt16 prefix(const uInt8* bytes)
+  {
+    return (bytes[0] << 8) | bytes[1];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  const PrefixIndex& prefixIndex()
+  {
+    static const unique_ptr<PrefixIndex> index = []() {
+      auto idx = make_unique<PrefixIndex>();
+      const PatternList& list = patterns();
+
+      // Count the patterns per prefix, then turn the counts into offsets
+      for(const auto& p: list)
+        ++idx->first[prefix(p.bytes.data()) + 1];
+      for(uInt32 i = 1; i <= 65536; ++i)
+        idx->first[i] += idx->first[i - 1];
+
+      vector<uInt16> fill(idx->first.begin(), idx->first.end() - 1);
+      for(uInt32 sig = 0; sig < NUM_SIGNATURES; ++sig)
+      {
+        const uInt16 key = prefix(list[sig].bytes.data());
+        idx->used[key >> 6] |= uInt64(1) << (key & 63);
+        idx->patterns[fill[key]++] = Signature(sig);
+      }
+      return idx;
+    }();
+
+    return *index;
+  }
+} // namespace
+
+/**
+  The positions of every signature in an image, found in a single pass.
+*/
+class CartDetector::Signatures
+{
+  public:
+    Signatures(const uInt8* image, size_t size);
+
+    /**
+      Same result as searchForBytes() for the given signature over the
+      first 'window' bytes of the image.
+    */
+    bool found(Signature sig, uInt32 minhits = 1,
+               size_t window = ~size_t(0)) const;
+
+    /**
+      True if at least one of the given signatures is found.
+    */
+    bool any(std::initializer_list<Signature> sigs) const;
+
+  private:
+    std::array<vector<uInt32>, NUM_SIGNATURES> myHits;
+    size_t mySize{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    Signatures() = delete;
+    Signatures(const Signatures&) = delete;
+    Signatures(Signatures&&) = delete;
+    Signatures& operator=(const Signatures&) = delete;
+    Signatures& operator=(Signatures&&) = delete;
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t size)
 {
+  // Find all signatures the heuristics below look for in one pass
+  const Signatures sigs(image.get(), size);
+
   // Guess type based on size
   Bankswitch::Type type = Bankswitch::Type::_AUTO;
 
@@ -37,15 +234,15 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   else if((size == 2_KB) ||
           (size == 4_KB && std::memcmp(image.get(), image.get() + 2_KB, 2_KB) == 0))
   {
-    type = isProbablyCV(image, size) ? Bankswitch::Type::_CV : Bankswitch::Type::_2K;
+    type = isProbablyCV(sigs) ? Bankswitch::Type::_CV : Bankswitch::Type::_2K;
   }
   else if(size == 4_KB)
   {
-    if(isProbablyCV(image, size))
+    if(isProbablyCV(sigs))
       type = Bankswitch::Type::_CV;
     else if(isProbably4KSC(image, size))
       type = Bankswitch::Type::_4KSC;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(sigs))
       type = Bankswitch::Type::_FC;
     else
       type = Bankswitch::Type::_4K;
@@ -53,36 +250,31 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   else if(size == 8_KB)
   {
     // First check for *potential* F8
-    uInt8 signature[2][3] = {
-      { 0x8D, 0xF9, 0x1F },  // STA $1FF9
-      { 0x8D, 0xF9, 0xFF }   // STA $FFF9
-    };
-    bool f8 = searchForBytes(image, size, signature[0], 3, 2) ||
-              searchForBytes(image, size, signature[1], 3, 2);
+    bool f8 = sigs.found(STA_1FF9, 2) || sigs.found(STA_FFF9, 2);
 
     if(isProbablySC(image, size))
       type = Bankswitch::Type::_F8SC;
     else if(std::memcmp(image.get(), image.get() + 4_KB, 4_KB) == 0)
       type = Bankswitch::Type::_4K;
-    else if(isProbablyE0(image, size))
+    else if(isProbablyE0(sigs))
       type = Bankswitch::Type::_E0;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
-    else if(isProbablyUA(image, size))
+    else if(isProbablyUA(sigs))
       type = Bankswitch::Type::_UA;
-    else if(isProbablyFE(image, size) && !f8)
+    else if(isProbablyFE(sigs) && !f8)
       type = Bankswitch::Type::_FE;
-    else if(isProbably0840(image, size))
+    else if(isProbably0840(sigs))
       type = Bankswitch::Type::_0840;
-    else if(isProbablyE78K(image, size))
+    else if(isProbablyE78K(sigs))
       type = Bankswitch::Type::_E78K;
-    else if (isProbablyWD(image,size))
+    else if (isProbablyWD(sigs))
       type = Bankswitch::Type::_WD;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(sigs))
       type = Bankswitch::Type::_FC;
     else
       type = Bankswitch::Type::_F8;
@@ -103,16 +295,16 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   {
     if(isProbablySC(image, size))
       type = Bankswitch::Type::_F6SC;
-    else if(isProbablyE7(image, size))
+    else if(isProbablyE7(sigs))
       type = Bankswitch::Type::_E7;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(sigs))
       type = Bankswitch::Type::_FC;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
   /* no known 16K 3F ROMS
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
   */
     else
@@ -124,121 +316,121 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   }
   else if(size == 29_KB)
   {
-    if(isProbablyARM(image, size))
+    if(isProbablyARM(sigs))
       type = Bankswitch::Type::_FA2;
-    else /*if(isProbablyDPCplus(image, size))*/
+    else /*if(isProbablyDPCplus(sigs))*/
       type = Bankswitch::Type::_DPCP;
   }
   else if(size == 32_KB)
   {
-    if (isProbablyCTY(image, size))
+    if (isProbablyCTY(sigs))
       type = Bankswitch::Type::_CTY;
     else if(isProbablySC(image, size))
       type = Bankswitch::Type::_F4SC;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyBUS(image, size))
+    else if (isProbablyBUS(sigs))
       type = Bankswitch::Type::_BUS;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(sigs))
       type = Bankswitch::Type::_CDF;
-    else if(isProbablyDPCplus(image, size))
+    else if(isProbablyDPCplus(sigs))
       type = Bankswitch::Type::_DPCP;
     else if(isProbablyFA2(image, size))
       type = Bankswitch::Type::_FA2;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(sigs))
       type = Bankswitch::Type::_FC;
     else
       type = Bankswitch::Type::_F4;
   }
   else if(size == 60_KB)
   {
-    if(isProbablyCTY(image, size))
+    if(isProbablyCTY(sigs))
       type = Bankswitch::Type::_CTY;
     else
       type = Bankswitch::Type::_F4;
   }
   else if(size == 64_KB)
   {
-    if(isProbably3EX(image, size))
+    if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(sigs))
       type = Bankswitch::Type::_CDF;
     else if(isProbably4A50(image, size))
       type = Bankswitch::Type::_4A50;
-    else if(isProbablyEF(image, size, type))
+    else if(isProbablyEF(image, size, sigs, type))
       ; // type has been set directly in the function
-    else if(isProbablyX07(image, size))
+    else if(isProbablyX07(sigs))
       type = Bankswitch::Type::_X07;
     else
       type = Bankswitch::Type::_F0;
   }
   else if(size == 128_KB)
   {
-    if(isProbably3EX(image, size))
+    if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
     else if(isProbablyDF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(sigs))
       type = Bankswitch::Type::_CDF;
     else if(isProbably4A50(image, size))
       type = Bankswitch::Type::_4A50;
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(sigs))*/
       type = Bankswitch::Type::_SB;
   }
   else if(size == 256_KB)
   {
-    if(isProbably3EX(image, size))
+    if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
     else if(isProbablyBF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(sigs))
       type = Bankswitch::Type::_CDF;
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(sigs))*/
       type = Bankswitch::Type::_SB;
   }
   else if(size == 512_KB)
   {
-    if(isProbablyTVBoy(image, size))
+    if(isProbablyTVBoy(sigs))
       type = Bankswitch::Type::_TVBOY;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(sigs))
       type = Bankswitch::Type::_CDF;
   }
   else  // what else can we do?
   {
-    if(isProbably3EX(image, size))
+    if(isProbably3EX(sigs))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(sigs))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(sigs))
       type = Bankswitch::Type::_3F;
   }
 
   // Variable sized ROM formats are independent of image size and come last
-  if(isProbably3EPlus(image, size))
+  if(isProbably3EPlus(sigs))
     type = Bankswitch::Type::_3EP;
-  else if(isProbablyMDM(image, size))
+  else if(isProbablyMDM(sigs))
     type = Bankswitch::Type::_MDM;
 
   // If we get here and autodetection failed, then we force '4K'
@@ -279,6 +471,70 @@ bool CartDetector::searchForBytes(const uInt8* image, size_t imagesize,
   return (count == minhits);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartDetector::Signatures::Signatures(const uInt8* image, size_t size)
+  : mySize(size)
+{
+  const PatternList& list = patterns();
+  const PrefixIndex& index = prefixIndex();
+
+  // Record every (possibly overlapping) position of every signature;
+  // found() then applies the counting rules of searchForBytes()
+  for(size_t i = 0; i + 1 < size; ++i)
+  {
+    const uInt16 key = prefix(image + i);
+    if(!(index.used[key >> 6] & (uInt64(1) << (key & 63))))
+      continue;
+
+    for(uInt32 k = index.first[key]; k < index.first[key + 1]; ++k)
+    {
+      const Signature sig = index.patterns[k];
+      const Pattern& p = list[sig];
+
+      if(i + p.size <= size &&
+         std::memcmp(image + i + 2, p.bytes.data() + 2, p.size - 2) == 0)
+        myHits[sig].push_back(uInt32(i));
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartDetector::Signatures::found(Signature sig, uInt32 minhits,
+                                     size_t window) const
+{
+  const size_t sigsize = patterns()[sig].size;
+  const size_t imagesize = std::min(mySize, window);
+
+  if(imagesize <= sigsize)
+    return false;
+
+  // Like searchForBytes(), only positions before the last possible one
+  // count, and a hit skips the rest of its window plus one byte
+  uInt32 count = 0;
+  size_t next = 0;
+
+  for(const uInt32 pos: myHits[sig])
+  {
+    if(pos >= imagesize - sigsize)
+      break;
+    if(pos >= next)
+    {
+      if(++count == minhits)
+        return true;
+      next = pos + sigsize + 1;
+    }
+  }
+
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartDetector::Signatures::any(std::initializer_list<Signature> sigs) const
+{
+  return std::any_of(sigs.begin(), sigs.end(),
+    [this](Signature sig) { return found(sig); });
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDetector::isProbablySC(const ByteBuffer& image, size_t size)
 {
@@ -297,85 +553,56 @@ bool CartDetector::isProbablySC(const ByteBuffer& image, size_t size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyARM(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyARM(const Signatures& sigs)
 {
   // ARM code contains the following 'loader' patterns in the first 1K
   // Thanks to Thomas Jentzsch of AtariAge for this advice
-  uInt8 signature[2][4] = {
-    { 0xA0, 0xC1, 0x1F, 0xE0 },
-    { 0x00, 0x80, 0x02, 0xE0 }
-  };
-  if(searchForBytes(image, std::min<size_t>(size, 1_KB), signature[0], 4))
-    return true;
-  else
-    return searchForBytes(image, std::min<size_t>(size, 1_KB), signature[1], 4);
+  return sigs.found(ARM_LOADER_1, 1, 1_KB) || sigs.found(ARM_LOADER_2, 1, 1_KB);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably0840(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably0840(const Signatures& sigs)
 {
   // 0840 cart bankswitching is triggered by accessing addresses 0x0800
   // or 0x0840 at least twice
-  uInt8 signature1[3][3] = {
-    { 0xAD, 0x00, 0x08 },  // LDA $0800
-    { 0xAD, 0x40, 0x08 },  // LDA $0840
-    { 0x2C, 0x00, 0x08 }   // BIT $0800
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature1[i], 3, 2))
-      return true;
-
-  uInt8 signature2[2][4] = {
-    { 0x0C, 0x00, 0x08, 0x4C },  // NOP $0800; JMP ...
-    { 0x0C, 0xFF, 0x0F, 0x4C }   // NOP $0FFF; JMP ...
-  };
-  for(uInt32 i = 0; i < 2; ++i)
-    if(searchForBytes(image, size, signature2[i], 4, 2))
-      return true;
-
-  return false;
+  return sigs.found(LDA_0800, 2) || sigs.found(LDA_0840, 2) ||
+         sigs.found(BIT_0800, 2) ||
+         sigs.found(NOP_0800_JMP, 2) || sigs.found(NOP_0FFF_JMP, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3E(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3E(const Signatures& sigs)
 {
   // 3E cart RAM bankswitching is triggered by storing the bank number
   // in address 3E using 'STA $3E', ROM bankswitching is triggered by
   // storing the bank number in address 3F using 'STA $3F'.
   // We expect the latter will be present at least 2 times, since there
   // are at least two banks
-
-  uInt8 signature1[] = { 0x85, 0x3E };  // STA $3E
-  uInt8 signature2[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image, size, signature1, 2)
-    && searchForBytes(image, size, signature2, 2, 2);
+  return sigs.found(STA_3E) && sigs.found(STA_3F, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3EX(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3EX(const Signatures& sigs)
 {
   // 3EX cart have at least 2 occurrences of the string "3EX"
-  uInt8 _3EX[] = { '3', 'E', 'X'};
-  return searchForBytes(image, size, _3EX, 3, 2);
+  return sigs.found(STRING_3EX, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3EPlus(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3EPlus(const Signatures& sigs)
 {
   // 3E+ cart is identified key 'TJ3E' in the ROM
-  uInt8 tj3e[] = { 'T', 'J', '3', 'E' };
-  return searchForBytes(image, size, tj3e, 4);
+  return sigs.found(STRING_TJ3E);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3F(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3F(const Signatures& sigs)
 {
   // 3F cart bankswitching is triggered by storing the bank number
   // in address 3F using 'STA $3F'
   // We expect it will be present at least 2 times, since there are
   // at least two banks
-  uInt8 signature[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image, size, signature, 2, 2);
+  return sigs.found(STA_3F, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -436,47 +663,35 @@ bool CartDetector::isProbablyBF(const ByteBuffer& image, size_t size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyBUS(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyBUS(const Signatures& sigs)
 {
   // BUS ARM code has 2 occurrences of the string BUS
   // Note: all Harmony/Melody custom drivers also contain the value
   // 0x10adab1e (LOADABLE) if needed for future improvement
-  uInt8 bus[] = { 'B', 'U', 'S'};
-  return searchForBytes(image, size, bus, 3, 2);
+  return sigs.found(STRING_BUS, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCDF(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyCDF(const Signatures& sigs)
 {
   // CDF ARM code has 3 occurrences of the string CDF
   // Note: all Harmony/Melody custom drivers also contain the value
   // 0x10adab1e (LOADABLE) if needed for future improvement
-  uInt8 cdf[] = { 'C', 'D', 'F' };
-  uInt8 cdfjplus[] = { 'P', 'L', 'U', 'S', 'C', 'D', 'F', 'J' };
-  return (searchForBytes(image, size, cdf, 3, 3) || 
-          searchForBytes(image, size, cdfjplus, 8, 1));
+  return sigs.found(STRING_CDF, 3) || sigs.found(STRING_PLUSCDFJ);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCTY(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyCTY(const Signatures& sigs)
 {
-  uInt8 lenin[] = { 'L', 'E', 'N', 'I', 'N' };
-  return searchForBytes(image, size, lenin, 5);
+  return sigs.found(STRING_LENIN);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCV(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyCV(const Signatures& sigs)
 {
   // CV RAM access occurs at addresses $f3ff and $f400
   // These signatures are attributed to the MESS project
-  uInt8 signature[2][3] = {
-    { 0x9D, 0xFF, 0xF3 },  // STA $F3FF.X
-    { 0x99, 0x00, 0xF4 }   // STA $F400.Y
-  };
-  if(searchForBytes(image, size, signature[0], 3))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3);
+  return sigs.any({ STA_F3FF_X, STA_F400_Y });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -503,17 +718,16 @@ bool CartDetector::isProbablyDF(const ByteBuffer& image, size_t size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyDPCplus(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyDPCplus(const Signatures& sigs)
 {
   // DPC+ ARM code has 2 occurrences of the string DPC+
   // Note: all Harmony/Melody custom drivers also contain the value
   // 0x10adab1e (LOADABLE) if needed for future improvement
-  uInt8 dpcp[] = { 'D', 'P', 'C', '+' };
-  return searchForBytes(image, size, dpcp, 4, 2);
+  return sigs.found(STRING_DPCP, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE0(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyE0(const Signatures& sigs)
 {
   // E0 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FF9 using absolute non-indexed addressing
@@ -521,25 +735,12 @@ bool CartDetector::isProbablyE0(const ByteBuffer& image, size_t size)
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
   // These signatures are attributed to the MESS project
-  uInt8 signature[8][3] = {
-    { 0x8D, 0xE0, 0x1F },  // STA $1FE0
-    { 0x8D, 0xE0, 0x5F },  // STA $5FE0
-    { 0x8D, 0xE9, 0xFF },  // STA $FFE9
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F },  // LDA $1FE0
-    { 0xAD, 0xE9, 0xFF },  // LDA $FFE9
-    { 0xAD, 0xED, 0xFF },  // LDA $FFED
-    { 0xAD, 0xF3, 0xBF }   // LDA $BFF3
-  };
-  for(uInt32 i = 0; i < 8; ++i)
-    if(searchForBytes(image, size, signature[i], 3))
-      return true;
-
-  return false;
+  return sigs.any({ STA_1FE0, STA_5FE0, STA_FFE9, NOP_1FE0,
+                    LDA_1FE0, LDA_FFE9, LDA_FFED, LDA_BFF3 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE7(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyE7(const Signatures& sigs)
 {
   // E7 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FE6 using absolute non-indexed addressing
@@ -547,44 +748,23 @@ bool CartDetector::isProbablyE7(const ByteBuffer& image, size_t size)
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
   // These signatures are attributed to the MESS project
-  uInt8 signature[7][3] = {
-    { 0xAD, 0xE2, 0xFF },  // LDA $FFE2
-    { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-    { 0xAD, 0xE5, 0x1F },  // LDA $1FE5
-    { 0xAD, 0xE7, 0x1F },  // LDA $1FE7
-    { 0x0C, 0xE7, 0x1F },  // NOP $1FE7
-    { 0x8D, 0xE7, 0xFF },  // STA $FFE7
-    { 0x8D, 0xE7, 0x1F }   // STA $1FE7
-  };
-  for(uInt32 i = 0; i < 7; ++i)
-    if(searchForBytes(image, size, signature[i], 3))
-      return true;
-
-  return false;
+  return sigs.any({ LDA_FFE2, LDA_FFE5, LDA_1FE5, LDA_1FE7,
+                    NOP_1FE7, STA_FFE7, STA_1FE7 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE78K(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyE78K(const Signatures& sigs)
 {
   // E78K cart bankswitching is triggered by accessing addresses
   // $FE4 to $FE6 using absolute non-indexed addressing
   // To eliminate false positives (and speed up processing), we
   // search for only certain known signatures
-  uInt8 signature[3][3] = {
-    { 0xAD, 0xE4, 0xFF },  // LDA $FFE4
-    { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-    { 0xAD, 0xE6, 0xFF },  // LDA $FFE6
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature[i], 3))
-      return true;
-
-  return false;
+  return sigs.any({ LDA_FFE4, LDA_FFE5, LDA_FFE6 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDetector::isProbablyEF(const ByteBuffer& image, size_t size,
-                                Bankswitch::Type& type)
+                                const Signatures& sigs, Bankswitch::Type& type)
 {
   // Newer EF carts store strings 'EFEF' and 'EFSC' starting at address $FFF8
   // This signature is attributed to "RevEng" of AtariAge
@@ -604,26 +784,10 @@ bool CartDetector::isProbablyEF(const ByteBuffer& image, size_t size,
   // Otherwise, EF cart bankswitching switches banks by accessing addresses
   // 0xFE0 to 0xFEF, usually with either a NOP or LDA
   // It's likely that the code will switch to bank 0, so that's what is tested
-  bool isEF = false;
-  uInt8 signature[4][3] = {
-    { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-    { 0xAD, 0xE0, 0xFF },  // LDA $FFE0
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F }   // LDA $1FE0
-  };
-  for(uInt32 i = 0; i < 4; ++i)
-  {
-    if(searchForBytes(image, size, signature[i], 3))
-    {
-      isEF = true;
-      break;
-    }
-  }
-
-  // Now that we know that the ROM is EF, we need to check if it's
-  // the SC variant
-  if(isEF)
+  if(sigs.any({ NOP_FFE0, LDA_FFE0, NOP_1FE0, LDA_1FE0 }))
   {
+    // Now that we know that the ROM is EF, we need to check if it's
+    // the SC variant
     type = isProbablySC(image, size) ? Bankswitch::Type::_EFSC : Bankswitch::Type::_EF;
     return true;
   }
@@ -647,72 +811,48 @@ bool CartDetector::isProbablyFA2(const ByteBuffer& image, size_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyFC(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyFC(const Signatures& sigs)
 {
-  // FC bankswitching uses consecutive writes to 3 hotspots
-  uInt8 signature[3][6] = {
-    { 0x8d, 0xf8, 0x1f, 0x4a, 0x4a, 0x8d }, // STA $1FF8, LSR, LSR, STA... Power Play Arcade Menus, 3-D Ghost Attack
-    { 0x8d, 0xf8, 0xff, 0x8d, 0xfc, 0xff }, // STA $FFF8, STA $FFFC        Surf's Up (4K)
-    { 0x8c, 0xf9, 0xff, 0xad, 0xfc, 0xff }  // STY $FFF9, LDA $FFFC        3-D Havoc
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature[i], 6))
-      return true;
-
-  return false;
+  // FC bankswitching uses consecutive writes to 3 hotspots:
+  //  STA $1FF8, LSR, LSR, STA...  Power Play Arcade Menus, 3-D Ghost Attack
+  //  STA $FFF8, STA $FFFC         Surf's Up (4K)
+  //  STY $FFF9, LDA $FFFC         3-D Havoc
+  return sigs.any({ STA_1FF8_LSR_LSR_STA, STA_FFF8_STA_FFFC, STY_FFF9_LDA_FFFC });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyFE(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyFE(const Signatures& sigs)
 {
   // FE bankswitching is very weird, but always seems to include a
   // 'JSR $xxxx'
   // These signatures are attributed to the MESS project
-  uInt8 signature[4][5] = {
-    { 0x20, 0x00, 0xD0, 0xC6, 0xC5 },  // JSR $D000; DEC $C5
-    { 0x20, 0xC3, 0xF8, 0xA5, 0x82 },  // JSR $F8C3; LDA $82
-    { 0xD0, 0xFB, 0x20, 0x73, 0xFE },  // BNE $FB; JSR $FE73
-    { 0x20, 0x00, 0xF0, 0x84, 0xD6 }   // JSR $F000; $84, $D6
-  };
-  for(uInt32 i = 0; i < 4; ++i)
-    if(searchForBytes(image, size, signature[i], 5))
-      return true;
-
-  return false;
+  return sigs.any({ JSR_D000_DEC_C5, JSR_F8C3_LDA_82,
+                    BNE_JSR_FE73, JSR_F000_STY_D6 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyMDM(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyMDM(const Signatures& sigs)
 {
   // MDM cart is identified key 'MDMC' in the first 8K of ROM
-  uInt8 mdmc[] = { 'M', 'D', 'M', 'C' };
-  return searchForBytes(image, std::min<size_t>(size, 8_KB), mdmc, 4);
+  return sigs.found(STRING_MDMC, 1, 8_KB);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablySB(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablySB(const Signatures& sigs)
 {
   // SB cart bankswitching switches banks by accessing address 0x0800
-  uInt8 signature[2][3] = {
-    { 0xBD, 0x00, 0x08 },  // LDA $0800,x
-    { 0xAD, 0x00, 0x08 }   // LDA $0800
-  };
-  if(searchForBytes(image, size, signature[0], 3))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3);
+  return sigs.any({ LDA_0800_X, LDA_0800 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyTVBoy(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyTVBoy(const Signatures& sigs)
 {
   // TV Boy cart bankswitching switches banks by accessing addresses 0x1800..$187F
-  uInt8 signature[5] = {0x91, 0x82, 0x6c, 0xfc, 0xff};  // STA ($82),Y; JMP ($FFFC)
-  return searchForBytes(image, size, signature, 5);
+  return sigs.found(STA_82_Y_JMP_FFFC);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyUA(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyUA(const Signatures& sigs)
 {
   // UA cart bankswitching switches to bank 1 by accessing address 0x240
   // using 'STA $240' or 'LDA $240'
@@ -720,47 +860,27 @@ bool CartDetector::isProbablyUA(const ByteBuffer& image, size_t size)
   // using 'BIT $2C0', 'STA $2C0' or 'LDA $2C0'
   // Other Brazilian (Atari Mania) ROM's bankswitching switches to bank 1 by accessing address 0xFC0
   // using 'BIT $FA0', 'BIT $FC0' or 'STA $FA0'
-  uInt8 signature[7][3] = {
-    { 0x8D, 0x40, 0x02 },  // STA $240 (Funky Fish, Pleiades)
-    { 0xAD, 0x40, 0x02 },  // LDA $240 (???)
-    { 0xBD, 0x1F, 0x02 },  // LDA $21F,X (Gingerbread Man)
-    { 0x2C, 0xC0, 0x02 },  // BIT $2C0 (Time Pilot)
-    { 0x8D, 0xC0, 0x02 },  // STA $2C0 (Fathom, Vanguard)
-    { 0xAD, 0xC0, 0x02 },  // LDA $2C0 (Mickey)
-    { 0x2C, 0xC0, 0x0F }   // BIT $FC0 (H.E.R.O., Kung-Fu Master)
-  };
-  for(uInt32 i = 0; i < 7; ++i)
-    if(searchForBytes(image, size, signature[i], 3))
-      return true;
-
-  return false;
+  return sigs.any({
+    STA_0240,    // Funky Fish, Pleiades
+    LDA_0240,
+    LDA_021F_X,  // Gingerbread Man
+    BIT_02C0,    // Time Pilot
+    STA_02C0,    // Fathom, Vanguard
+    LDA_02C0,    // Mickey
+    BIT_0FC0     // H.E.R.O., Kung-Fu Master
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyWD(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyWD(const Signatures& sigs)
 {
   // WD cart bankswitching switches banks by accessing address 0x30..0x3f
-  uInt8 signature[1][3] = {
-    { 0xA5, 0x39, 0x4C }  // LDA $39, JMP
-  };
-  return searchForBytes(image, size, signature[0], 3);
+  return sigs.found(LDA_39_JMP);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyX07(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyX07(const Signatures& sigs)
 {
   // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
-  uInt8 signature[6][3] = {
-    { 0xAD, 0x0D, 0x08 },  // LDA $080D
-    { 0xAD, 0x1D, 0x08 },  // LDA $081D
-    { 0xAD, 0x2D, 0x08 },  // LDA $082D
-    { 0x0C, 0x0D, 0x08 },  // NOP $080D
-    { 0x0C, 0x1D, 0x08 },  // NOP $081D
-    { 0x0C, 0x2D, 0x08 }   // NOP $082D
-  };
-  for(uInt32 i = 0; i < 6; ++i)
-    if(searchForBytes(image, size, signature[i], 3))
-      return true;
-
-  return false;
+  return sigs.any({ LDA_080D, LDA_081D, LDA_082D, NOP_080D, NOP_081D, NOP_082D });
 }
@@ -56,12 +56,11 @@ class CartDetector
                                const uInt8* signature, uInt32 sigsize,
                                uInt32 minhits = 1);
 
-    static bool searchForBytes(const ByteBuffer& image, size_t imagesize,
-                               const uInt8* signature, uInt32 sigsize,
-                               uInt32 minhits = 1)
-    {
-      return searchForBytes(image.get(), imagesize, signature, sigsize, minhits);
-    }
+    /**
+      The hits of all signatures used by the heuristics below, collected in
+      a single pass over the image and counted like searchForBytes() does
+    */
+    class Signatures;
 
     /**
       Returns true if the image is probably a SuperChip (128 bytes RAM)
@@ -72,32 +71,32 @@ class CartDetector
     /**
       Returns true if the image probably contains ARM code in the first 1K
     */
-    static bool isProbablyARM(const ByteBuffer& image, size_t size);
+    static bool isProbablyARM(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a 0840 bankswitching cartridge
     */
-    static bool isProbably0840(const ByteBuffer& image, size_t size);
+    static bool isProbably0840(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a 3E bankswitching cartridge
     */
-    static bool isProbably3E(const ByteBuffer& image, size_t size);
+    static bool isProbably3E(const Signatures& sigs);
 
     /**
     Returns true if the image is probably a 3EX bankswitching cartridge
     */
-    static bool isProbably3EX(const ByteBuffer& image, size_t size);
+    static bool isProbably3EX(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a 3E+ bankswitching cartridge
     */
-    static bool isProbably3EPlus(const ByteBuffer& image, size_t size);
+    static bool isProbably3EPlus(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a 3F bankswitching cartridge
     */
-    static bool isProbably3F(const ByteBuffer& image, size_t size);
+    static bool isProbably3F(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a 4A50 bankswitching cartridge
@@ -117,22 +116,22 @@ class CartDetector
     /**
       Returns true if the image is probably a BUS bankswitching cartridge
     */
-    static bool isProbablyBUS(const ByteBuffer& image, size_t size);
+    static bool isProbablyBUS(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a CDF bankswitching cartridge
     */
-    static bool isProbablyCDF(const ByteBuffer& image, size_t size);
+    static bool isProbablyCDF(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a CTY bankswitching cartridge
     */
-    static bool isProbablyCTY(const ByteBuffer& image, size_t size);
+    static bool isProbablyCTY(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a CV bankswitching cartridge
     */
-    static bool isProbablyCV(const ByteBuffer& image, size_t size);
+    static bool isProbablyCV(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a DF/DFSC bankswitching cartridge
@@ -142,27 +141,28 @@ class CartDetector
     /**
       Returns true if the image is probably a DPC+ bankswitching cartridge
     */
-    static bool isProbablyDPCplus(const ByteBuffer& image, size_t size);
+    static bool isProbablyDPCplus(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a E0 bankswitching cartridge
     */
-    static bool isProbablyE0(const ByteBuffer& image, size_t size);
+    static bool isProbablyE0(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a E7 bankswitching cartridge
     */
-    static bool isProbablyE7(const ByteBuffer& image, size_t size);
+    static bool isProbablyE7(const Signatures& sigs);
 
     /**
     Returns true if the image is probably a E78K bankswitching cartridge
     */
-    static bool isProbablyE78K(const ByteBuffer& image, size_t size);
+    static bool isProbablyE78K(const Signatures& sigs);
 
     /**
       Returns true if the image is probably an EF/EFSC bankswitching cartridge
     */
-    static bool isProbablyEF(const ByteBuffer& image, size_t size, Bankswitch::Type& type);
+    static bool isProbablyEF(const ByteBuffer& image, size_t size,
+                             const Signatures& sigs, Bankswitch::Type& type);
 
     /**
       Returns true if the image is probably an F6 bankswitching cartridge
@@ -177,42 +177,42 @@ class CartDetector
     /**
       Returns true if the image is probably an FC bankswitching cartridge
     */
-    static bool isProbablyFC(const ByteBuffer& image, size_t size);
+    static bool isProbablyFC(const Signatures& sigs);
 
     /**
       Returns true if the image is probably an FE bankswitching cartridge
     */
-    static bool isProbablyFE(const ByteBuffer& image, size_t size);
+    static bool isProbablyFE(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a MDM bankswitching cartridge
     */
-    static bool isProbablyMDM(const ByteBuffer& image, size_t size);
+    static bool isProbablyMDM(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a SB bankswitching cartridge
     */
-    static bool isProbablySB(const ByteBuffer& image, size_t size);
+    static bool isProbablySB(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a TV Boy bankswitching cartridge
     */
-    static bool isProbablyTVBoy(const ByteBuffer& image, size_t size);
+    static bool isProbablyTVBoy(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a UA bankswitching cartridge
     */
-    static bool isProbablyUA(const ByteBuffer& image, size_t size);
+    static bool isProbablyUA(const Signatures& sigs);
 
     /**
       Returns true if the image is probably a Wickstead Design bankswitching cartridge
     */
-    static bool isProbablyWD(const ByteBuffer& image, size_t size);
+    static bool isProbablyWD(const Signatures& sigs);
 
     /**
       Returns true if the image is probably an X07 bankswitching cartridge
     */
-    static bool isProbablyX07(const ByteBuffer& image, size_t size);
+    static bool isProbablyX07(const Signatures& sigs);
 
   private:
     // Following constructors and assignment operators not supported
@@ -87,6 +87,11 @@ void CartridgeEnhanced::install(System& system)
   // Allocate array for the segment's current bank offset
   myCurrentSegOffset = make_unique<uInt32[]>(myBankSegs);
 
+  // The page access methods refer to the arrays above, so they must be
+  // recreated
+  myRomPageAccess.clear();
+  myRomPageAccess.resize(size_t(myBankSegs) * romBankCount());
+
   // Allocate array for the RAM area
   if(myRamSize > 0)
     myRAM = make_unique<uInt8[]>(myRamSize);
@@ -245,33 +250,44 @@ bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
     const uInt16 romBank = bank % romBankCount();
     // Remember what bank is in this segment
     const uInt32 bankOffset = myCurrentSegOffset[segment] = romBank << myBankShift;
-    const uInt16 hotspot = this->hotspot();
-    uInt16 hotSpotAddr;
+    const uInt16 segmentAddr = ROM_OFFSET + segmentOffset;
     // Skip extra RAM; if existing it is only mapped into first segment
-    const uInt16 fromAddr = (ROM_OFFSET + segmentOffset + (segment == 0 ? myRomOffset : 0)) & ~System::PAGE_MASK;
-    // for ROMs < 4_KB, the whole address space will be mapped.
-    const uInt16 toAddr   = (ROM_OFFSET + segmentOffset + (mySize < 4_KB ? 4_KB : myBankSize)) & ~System::PAGE_MASK;
-
-    if(hotspot & 0x1000)
-      hotSpotAddr = (hotspot & ~System::PAGE_MASK);
-    else
-      hotSpotAddr = 0xFFFF; // none
+    const uInt16 fromAddr = (segmentAddr + (segment == 0 ? myRomOffset : 0)) & ~System::PAGE_MASK;
+    vector<System::PageAccess>& pages =
+      myRomPageAccess[size_t(segment) * romBankCount() + romBank];
 
-    System::PageAccess access(this, System::PageAccessType::READ);
-    // Setup the page access methods for the current bank
-    for(uInt16 addr = fromAddr; addr < toAddr; addr += System::PAGE_SIZE)
+    // The pages are created for the whole segment, so that they don't depend
+    // on the extra RAM
+    if(pages.empty())
     {
-      const uInt32 offset = bankOffset + (addr & myBankMask);
+      const uInt16 hotspot = this->hotspot();
+      uInt16 hotSpotAddr;
+      // for ROMs < 4_KB, the whole address space will be mapped.
+      const uInt16 toAddr   = (segmentAddr + (mySize < 4_KB ? 4_KB : myBankSize)) & ~System::PAGE_MASK;
 
-      if(myDirectPeek && addr != hotSpotAddr)
-        access.directPeekBase = &myImage[offset];
+      if(hotspot & 0x1000)
+        hotSpotAddr = (hotspot & ~System::PAGE_MASK);
       else
-        access.directPeekBase = nullptr;
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
-      mySystem->setPageAccess(addr, access);
+        hotSpotAddr = 0xFFFF; // none
+
+      System::PageAccess access(this, System::PageAccessType::READ);
+      // Setup the page access methods for this bank
+      for(uInt16 addr = segmentAddr; addr < toAddr; addr += System::PAGE_SIZE)
+      {
+        const uInt32 offset = bankOffset + (addr & myBankMask);
+
+        if(myDirectPeek && addr != hotSpotAddr)
+          access.directPeekBase = &myImage[offset];
+        else
+          access.directPeekBase = nullptr;
+        access.romAccessBase = &myRomAccessBase[offset];
+        access.romPeekCounter = &myRomAccessCounter[offset];
+        access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
+        pages.push_back(access);
+      }
     }
+    const size_t skip = std::min<size_t>((fromAddr - segmentAddr) >> System::PAGE_SHIFT, pages.size());
+    mySystem->setPageAccess(fromAddr, pages.data() + skip, pages.size() - skip);
   }
   else
   {
@@ -22,6 +22,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "System.hxx"
 #include "PlusROM.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartEnhancedWidget.hxx"
@@ -216,6 +217,11 @@ class CartridgeEnhanced : public Cartridge
     // Contains the offset into the ROM image for each of the bank segments
     DWordBuffer myCurrentSegOffset{nullptr};
 
+    // The page access methods of each ROM bank in each segment, indexed by
+    // segment * romBankCount() + bank; each is created on first use and
+    // then installed as a whole
+    vector<vector<System::PageAccess>> myRomPageAccess;
+
     // Indicates whether to use direct ROM peeks or not
     bool myDirectPeek{true};
 
@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CLOCK_CONVERTER_HXX
+#define CLOCK_CONVERTER_HXX
+
+#include <numeric>
+
+#include "Serializer.hxx"
+#include "bspf.hxx"
+
+/**
+  Converts clocks from one clock domain into another (e.g. 6507 cycles into
+  the clocks of the music data fetchers of a cartridge) at a fixed ratio.
+
+  Only integer arithmetic is used, and the fraction of a clock left over by
+  a conversion is carried into the next one.  So no clocks are ever lost,
+  and the results are identical on all platforms.
+
+  @author  Stella Team
+*/
+class ClockConverter
+{
+  public:
+    /**
+      Create a converter from clocks running at 'fromRate' into clocks
+      running at 'toRate'; both rates must be given in the same unit.
+    */
+    ClockConverter(uInt64 toRate = 0, uInt64 fromRate = 1) {
+      setRates(toRate, fromRate);
+    }
+
+    /**
+      Create a converter from 6507 cycles into clocks running at the given
+      rate (in Hz).
+    */
+    static ClockConverter fromCpuCycles(uInt64 toRate) {
+      return ClockConverter(toRate * 3, CPU_CLOCK_RATE_X3);
+    }
+
+    /**
+      Change the conversion ratio, and drop any leftover fraction.
+    */
+    void setRates(uInt64 toRate, uInt64 fromRate) {
+      const uInt64 divisor = std::gcd(toRate, fromRate);
+
+      myNumerator = toRate / divisor;
+      myDenominator = fromRate / divisor;
+      myRemainder = 0;
+    }
+
+    /**
+      Convert the given number of clocks, including the fraction left over
+      by the last conversion.
+
+      @param clocks  The number of clocks in the source domain
+      @return  The number of whole clocks in the target domain
+    */
+    uInt32 convert(uInt32 clocks) {
+      const uInt64 scaled = uInt64(clocks) * myNumerator + myRemainder;
+
+      myRemainder = scaled % myDenominator;
+      return uInt32(scaled / myDenominator);
+    }
+
+    /**
+      Drop the fraction left over by the last conversion.
+    */
+    void reset() { myRemainder = 0; }
+
+    /**
+      Save/load the leftover fraction to/from the given Serializer.
+    */
+    void save(Serializer& out) const { out.putLong(myRemainder); }
+    void load(Serializer& in) {
+      // Never trust the state to contain a valid fraction
+      myRemainder = in.getLong() % myDenominator;
+    }
+
+  private:
+    // The emulated 6507 runs at 1193191.67 Hz, which is the NTSC color clock
+    // (3579575 Hz) divided by 3; rates are multiplied by 3 to stay integral
+    static constexpr uInt64 CPU_CLOCK_RATE_X3 = 3579575;
+
+    // The conversion ratio, reduced to its lowest terms
+    uInt64 myNumerator{0}, myDenominator{1};
+
+    // The leftover fraction of a clock, in units of 1/myDenominator
+    uInt64 myRemainder{0};
+};
+
+#endif
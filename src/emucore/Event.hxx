@@ -18,7 +18,7 @@
 #ifndef EVENT_HXX
 #define EVENT_HXX
 
-#include <mutex>
+#include <atomic>
 #include <set>
 
 #include "bspf.hxx"
@@ -194,18 +194,14 @@ class Event
       Get the value associated with the event of the specified type.
     */
     Int32 get(Type type) const {
-      std::lock_guard<std::mutex> lock(myMutex);
-
-      return myValues[type];
+      return myValues[type].load(std::memory_order_relaxed);
     }
 
     /**
       Set the value associated with the event of the specified type.
     */
     void set(Type type, Int32 value) {
-      std::lock_guard<std::mutex> lock(myMutex);
-
-      myValues[type] = value;
+      myValues[type].store(value, std::memory_order_relaxed);
     }
 
     /**
@@ -213,9 +209,8 @@ class Event
     */
     void clear()
     {
-      std::lock_guard<std::mutex> lock(myMutex);
-
-      myValues.fill(Event::NoType);
+      for(auto& value: myValues)
+        value.store(Event::NoType, std::memory_order_relaxed);
     }
 
     /**
@@ -236,10 +231,10 @@ class Event
     }
 
   private:
-    // Array of values associated with each event type
-    std::array<Int32, LastType> myValues;
-
-    mutable std::mutex myMutex;
+    // Array of values associated with each event type.  Every value is
+    // independent of the others, so the emulation can read them without
+    // locking while the event handler updates them.
+    std::array<std::atomic<Int32>, LastType> myValues;
 
   private:
     // Following constructors and assignment operators not supported
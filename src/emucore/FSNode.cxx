@@ -328,6 +328,12 @@ bool FilesystemNode::isWritable() const
   return _realNode ? _realNode->isWritable() : false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::getFileInfo(uInt64& size, uInt64& time) const
+{
+  return _realNode ? _realNode->getFileInfo(size, time) : false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNode::makeDir()
 {
@@ -219,6 +219,15 @@ class FilesystemNode
      */
     bool isWritable() const;
 
+    /**
+     * Get the size of the file and the time of its last modification, e.g.
+     * to detect whether a file has changed.  The unit of the time depends
+     * on the platform.
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    bool getFileInfo(uInt64& size, uInt64& time) const;
+
     /**
      * Create a directory from the current node path.
      *
@@ -413,6 +422,15 @@ class AbstractFSNode
      */
     virtual bool isWritable() const = 0;
 
+    /**
+     * Get the size of the file and the time of its last modification, e.g.
+     * to detect whether a file has changed.  The unit of the time depends
+     * on the platform.
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    virtual bool getFileInfo(uInt64& size, uInt64& time) const { return false; }
+
     /**
      * Create a directory from the current node path.
      *
@@ -45,6 +45,11 @@
 #include "exception/EmulationWarning.hxx"
 #include "exception/FatalEmulationError.hxx"
 
+// The threaded dispatcher relies on the 'labels as values' extension
+#if defined(M6502_THREADED_DISPATCH) && !defined(__GNUC__)
+  #undef M6502_THREADED_DISPATCH
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(const Settings& settings)
   : mySettings{settings}
@@ -189,7 +194,22 @@ inline void M6502::handleHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::execute(uInt64 number, DispatchResult& result)
 {
-  _execute(number, result);
+#ifdef DEBUGGER_SUPPORT
+  // Only pay for the per-instruction debugger checks if any are armed
+  // Cart RAM accesses are only checked (and cleared) per instruction in
+  // the debugger loop, so don't let them pile up otherwise
+  const bool hooks = debugHooksActive();
+  mySystem->cart().trackRAMAccesses(hooks);
+  if(hooks)
+    _execute<true>(number, result);
+  else
+  {
+    mySystem->cart().clearAllRAMAccesses();
+    _execute<false>(number, result);
+  }
+#else
+  _execute<false>(number, result);
+#endif
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger hack: this ensures that stepping a "STA WSYNC" will actually end at the
@@ -216,84 +236,305 @@ bool M6502::execute(uInt64 number)
   return result.isSuccess();
 }
 
+#ifdef DEBUGGER_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool M6502::checkDebuggerBreak(uInt64 currentCycles, DispatchResult& result)
+{
+  // Don't break if we haven't actually executed anything yet
+  if (myLastBreakCycle != mySystem->cycles()) {
+    if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
+    {
+      bool read = myJustHitReadTrapFlag;
+      myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
+
+      myLastBreakCycle = mySystem->cycles();
+      result.setDebugger(currentCycles, myHitTrapInfo.message,
+                         read ? "Read trap" : "Write trap",
+                         myHitTrapInfo.address, read);
+      return true;
+    }
+
+    if(myBreakPoints.isInitialized())
+    {
+      uInt8 bank = mySystem->cart().getBank(PC);
+
+      if(myBreakPoints.check(PC, bank))
+      {
+        myLastBreakCycle = mySystem->cycles();
+        // disable a one-shot breakpoint
+        if(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT)
+        {
+          myBreakPoints.erase(PC, bank);
+        }
+        else
+        {
+          ostringstream msg;
+
+          msg << "BP: $" << Common::Base::HEX4 << PC << ", bank #" << std::dec << int(bank);
+          result.setDebugger(currentCycles, msg.str(), "Breakpoint");
+        }
+        return true;
+      }
+    }
+
+    int cond = evalCondBreaks();
+    if(cond > -1)
+    {
+      ostringstream msg;
+
+      msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
+
+      myLastBreakCycle = mySystem->cycles();
+      result.setDebugger(currentCycles, msg.str(), "Conditional breakpoint");
+      return true;
+    }
+  }
+
+  int cond = evalCondSaveStates();
+  if(cond > -1)
+  {
+    ostringstream msg;
+    msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
+    myDebugger->addState(msg.str());
+  }
+
+  mySystem->cart().clearAllRAMAccesses();
+
+  // The instruction is going to be executed now
+  if(myTraceRecorder)
+    myTraceRecorder->record(*this);
+  if(myProfiler)
+    myProfiler->sample(*this);
+
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool M6502::checkPortAccessBreak(uInt64 currentCycles, uInt16 oldPC,
+                                        DispatchResult& result)
+{
+  if(myReadFromWritePortBreak)
+  {
+    uInt16 rwpAddr = mySystem->cart().getIllegalRAMReadAccess();
+    if(rwpAddr)
+    {
+      ostringstream msg;
+      msg << "RWP[@ $" << Common::Base::HEX4 << rwpAddr << "]: ";
+      result.setDebugger(currentCycles, msg.str(), "Read from write port", oldPC);
+      return true;
+    }
+  }
+
+  if (myWriteToReadPortBreak)
+  {
+    uInt16 wrpAddr = mySystem->cart().getIllegalRAMWriteAccess();
+    if (wrpAddr)
+    {
+      ostringstream msg;
+      msg << "WRP[@ $" << Common::Base::HEX4 << wrpAddr << "]: ";
+      result.setDebugger(currentCycles, msg.str(), "Write to read port", oldPC);
+      return true;
+    }
+  }
+
+  return false;
+}
+#endif  // DEBUGGER_SUPPORT
+
+#ifdef M6502_THREADED_DISPATCH
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugHooks>
 inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
 {
-  myExecutionStatus = 0;
+  // Handler address for every opcode; the JAM opcodes have none in M6502.ins
+  static const void* const ourDispatchTable[256] = {
+    &&op_0x00, &&op_0x01, &&op_invalid, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+    &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+    &&op_0x10, &&op_0x11, &&op_invalid, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+    &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+    &&op_0x20, &&op_0x21, &&op_invalid, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+    &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+    &&op_0x30, &&op_0x31, &&op_invalid, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+    &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+    &&op_0x40, &&op_0x41, &&op_invalid, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+    &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+    &&op_0x50, &&op_0x51, &&op_invalid, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+    &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+    &&op_0x60, &&op_0x61, &&op_invalid, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+    &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+    &&op_0x70, &&op_0x71, &&op_invalid, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+    &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+    &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+    &&op_0x88, &&op_0x89, &&op_0x8a, &&op_0x8b, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+    &&op_0x90, &&op_0x91, &&op_invalid, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+    &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+    &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+    &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+    &&op_0xb0, &&op_0xb1, &&op_invalid, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+    &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+    &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7,
+    &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+    &&op_0xd0, &&op_0xd1, &&op_invalid, &&op_0xd3, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7,
+    &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_0xdb, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_0xdf,
+    &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_0xe3, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_0xe7,
+    &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_0xeb, &&op_0xec, &&op_0xed, &&op_0xee, &&op_0xef,
+    &&op_0xf0, &&op_0xf1, &&op_invalid, &&op_0xf3, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_0xf7,
+    &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_0xfb, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_0xff
+  };
 
-#ifdef DEBUGGER_SUPPORT
-  TIA& tia = mySystem->tia();
-  M6532& riot = mySystem->m6532();
-#endif
+  myExecutionStatus = 0;
 
-  uInt64 previousCycles = mySystem->cycles();
+  const uInt64 previousCycles = mySystem->cycles();
+  const uInt64 cycleLimit = cycles * SYSTEM_CYCLES_PER_CPU;
   uInt64 currentCycles = 0;
 
+  // Without debugger hooks, every handler fetches and dispatches the next
+  // instruction itself; otherwise all handlers share the debugger checks
+  // at 'instruction_done'
+  #define M6502_DISPATCH                                 \
+    currentCycles = mySystem->cycles() - previousCycles; \
+    if(myExecutionStatus || currentCycles >= cycleLimit) \
+      goto instructions_done;                            \
+    myDataAddressForPoke = 0;                            \
+    icycles = 0;                                         \
+    IR = peek(PC++, DISASM_CODE);                        \
+    goto *ourDispatchTable[IR];
+
+  #define M6502_OPCODE(_op) op_##_op:
+  #define M6502_OPCODE_END \
+    if constexpr(debugHooks) goto instruction_done; else { M6502_DISPATCH }
+
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
-    while (!myExecutionStatus && currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
-    {
+    // Exceptions always leave the instruction loop, so the handlers are set
+    // up once here instead of once per instruction
+    try {
+      uInt16 operandAddress = 0, intermediateAddress = 0;
+      uInt8 operand = 0;
   #ifdef DEBUGGER_SUPPORT
-      // Don't break if we haven't actually executed anything yet
-      if (myLastBreakCycle != mySystem->cycles()) {
-        if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
-        {
-          bool read = myJustHitReadTrapFlag;
-          myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
+      uInt16 oldPC = 0;
+  #endif
+
+    next_instruction:
+      if(myExecutionStatus || currentCycles >= cycleLimit)
+        goto instructions_done;
 
-          myLastBreakCycle = mySystem->cycles();
-          result.setDebugger(currentCycles, myHitTrapInfo.message,
-                             read ? "Read trap" : "Write trap",
-                             myHitTrapInfo.address, read);
+  #ifdef DEBUGGER_SUPPORT
+      if constexpr(debugHooks)
+      {
+        if(checkDebuggerBreak(currentCycles, result))
           return;
-        }
 
-        if(myBreakPoints.isInitialized())
-        {
-          uInt8 bank = mySystem->cart().getBank(PC);
-
-          if(myBreakPoints.check(PC, bank))
-          {
-            myLastBreakCycle = mySystem->cycles();
-            // disable a one-shot breakpoint
-            if(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT)
-            {
-              myBreakPoints.erase(PC, bank);
-            }
-            else
-            {
-              ostringstream msg;
-
-              msg << "BP: $" << Common::Base::HEX4 << PC << ", bank #" << std::dec << int(bank);
-              result.setDebugger(currentCycles, msg.str(), "Breakpoint");
-            }
-            return;
-          }
-        }
+        oldPC = PC;
+      }
+  #endif
 
-        int cond = evalCondBreaks();
-        if(cond > -1)
-        {
-          ostringstream msg;
+      // Reset the data poke address pointer
+      myDataAddressForPoke = 0;
+      icycles = 0;
+
+      // Fetch instruction at the program counter
+      IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+      goto *ourDispatchTable[IR];
+
+      // 6502 instruction emulation is generated by an M4 macro file
+      #include "M6502.ins"
 
-          msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
+    op_invalid:
+      FatalEmulationError::raise("invalid instruction");
 
-          myLastBreakCycle = mySystem->cycles();
-          result.setDebugger(currentCycles, msg.str(), "Conditional breakpoint");
+    // Only reached through the handlers when debugger hooks are active
+    instruction_done: __attribute__((unused));
+  #ifdef DEBUGGER_SUPPORT
+      if constexpr(debugHooks)
+        if(checkPortAccessBreak(currentCycles, oldPC, result))
           return;
+  #endif
+
+      currentCycles = (mySystem->cycles() - previousCycles);
+
+  #ifdef DEBUGGER_SUPPORT
+      if constexpr(debugHooks)
+        if(myStepStateByInstruction)
+        {
+          // Check out M6502::execute for an explanation.
+          handleHalt();
+
+          mySystem->tia().updateEmulation();
+          mySystem->m6532().updateEmulation();
         }
-      }
+  #endif
+      goto next_instruction;
+    } catch (const FatalEmulationError& e) {
+      myExecutionStatus |= FatalErrorBit;
+      result.setMessage(e.what());
+      currentCycles = (mySystem->cycles() - previousCycles);
+    } catch (const EmulationWarning& e) {
+      result.setDebugger(currentCycles, e.what(), "Emulation exception", PC);
+      return;
+    }
 
-      int cond = evalCondSaveStates();
-      if(cond > -1)
-      {
-        ostringstream msg;
-        msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
-        myDebugger->addState(msg.str());
-      }
+  instructions_done:
+    // See if we need to handle an interrupt
+    if((myExecutionStatus & MaskableInterruptBit) ||
+        (myExecutionStatus & NonmaskableInterruptBit))
+    {
+      // Yes, so handle the interrupt
+      interruptHandler();
+    }
 
-      mySystem->cart().clearAllRAMAccesses();
+    // See if a fatal error has occurred
+    if(myExecutionStatus & FatalErrorBit)
+    {
+      // Yes, so answer that something when wrong. The message has already been set when
+      // the exception was handled.
+      result.setFatal(currentCycles);
+      return;
+    }
+
+    // See if execution has been stopped
+    if(myExecutionStatus & StopExecutionBit)
+    {
+      // Yes, so answer that everything finished fine
+      result.setOk(currentCycles);
+      return;
+    }
+
+    if (currentCycles >= cycleLimit) {
+      result.setOk(currentCycles);
+      return;
+    }
+  }
+
+  #undef M6502_DISPATCH
+  #undef M6502_OPCODE
+  #undef M6502_OPCODE_END
+}
+
+#pragma GCC diagnostic pop
+#else
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugHooks>
+inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
+{
+  myExecutionStatus = 0;
+
+  uInt64 previousCycles = mySystem->cycles();
+  uInt64 currentCycles = 0;
+
+  // Loop until execution is stopped or a fatal error occurs
+  for(;;)
+  {
+    while (!myExecutionStatus && currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
+    {
+  #ifdef DEBUGGER_SUPPORT
+      if constexpr(debugHooks)
+        if(checkDebuggerBreak(currentCycles, result))
+          return;
   #endif  // DEBUGGER_SUPPORT
 
       // Reset the data poke address pointer
@@ -322,29 +563,9 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         }
 
     #ifdef DEBUGGER_SUPPORT
-        if(myReadFromWritePortBreak)
-        {
-          uInt16 rwpAddr = mySystem->cart().getIllegalRAMReadAccess();
-          if(rwpAddr)
-          {
-            ostringstream msg;
-            msg << "RWP[@ $" << Common::Base::HEX4 << rwpAddr << "]: ";
-            result.setDebugger(currentCycles, msg.str(), "Read from write port", oldPC);
+        if constexpr(debugHooks)
+          if(checkPortAccessBreak(currentCycles, oldPC, result))
             return;
-          }
-        }
-
-        if (myWriteToReadPortBreak)
-        {
-          uInt16 wrpAddr = mySystem->cart().getIllegalRAMWriteAccess();
-          if (wrpAddr)
-          {
-            ostringstream msg;
-            msg << "WRP[@ $" << Common::Base::HEX4 << wrpAddr << "]: ";
-            result.setDebugger(currentCycles, msg.str(), "Write to read port", oldPC);
-            return;
-          }
-        }
     #endif  // DEBUGGER_SUPPORT
       } catch (const FatalEmulationError& e) {
         myExecutionStatus |= FatalErrorBit;
@@ -357,14 +578,15 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
       currentCycles = (mySystem->cycles() - previousCycles);
 
   #ifdef DEBUGGER_SUPPORT
-      if(myStepStateByInstruction)
-      {
-        // Check out M6502::execute for an explanation.
-        handleHalt();
+      if constexpr(debugHooks)
+        if(myStepStateByInstruction)
+        {
+          // Check out M6502::execute for an explanation.
+          handleHalt();
 
-        tia.updateEmulation();
-        riot.updateEmulation();
-      }
+          mySystem->tia().updateEmulation();
+          mySystem->m6532().updateEmulation();
+        }
   #endif
     }
 
@@ -399,6 +621,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
     }
   }
 }
+#endif  // M6502_THREADED_DISPATCH
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::interruptHandler()
@@ -537,7 +760,7 @@ void M6502::attach(Debugger& debugger)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondBreak(Expression* e, const string& name, bool oneShot)
 {
-  myCondBreaks.emplace_back(e);
+  myCondBreaks.emplace_back(make_unique<CompiledExpression>(e, *mySystem));
   myCondBreakNames.push_back(name);
 
   updateStepStateByInstruction();
@@ -578,7 +801,7 @@ const StringList& M6502::getCondBreakNames() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondSaveState(Expression* e, const string& name)
 {
-  myCondSaveStates.emplace_back(e);
+  myCondSaveStates.emplace_back(make_unique<CompiledExpression>(e, *mySystem));
   myCondSaveStateNames.push_back(name);
 
   updateStepStateByInstruction();
@@ -619,7 +842,7 @@ const StringList& M6502::getCondSaveStateNames() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondTrap(Expression* e, const string& name)
 {
-  myTrapConds.emplace_back(e);
+  myTrapConds.emplace_back(make_unique<CompiledExpression>(e, *mySystem));
   myTrapCondNames.push_back(name);
 
   updateStepStateByInstruction();
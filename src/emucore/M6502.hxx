@@ -28,9 +28,11 @@ class DispatchResult;
   class Debugger;
   class CpuDebug;
 
-  #include "Expression.hxx"
+  #include "CompiledExpression.hxx"
   #include "TrapArray.hxx"
   #include "BreakpointMap.hxx"
+  #include "TraceRecorder.hxx"
+  #include "CpuProfiler.hxx"
 #endif
 
 #include "bspf.hxx"
@@ -54,6 +56,8 @@ class M6502 : public Serializable
   // The 6502 and Cart debugger classes are friends who need special access
   friend class CartDebug;
   friend class CpuDebug;
+  friend class TraceRecorder;
+  friend class CpuProfiler;
 
   public:
 
@@ -252,6 +256,18 @@ class M6502 : public Serializable
     void clearCondTraps();
     const StringList& getCondTrapNames() const;
 
+    // methods for 'tracerec' handling; an empty recorder stops recording
+    void setTraceRecorder(unique_ptr<TraceRecorder> recorder) {
+      myTraceRecorder = std::move(recorder);
+    }
+    TraceRecorder* traceRecorder() const { return myTraceRecorder.get(); }
+
+    // methods for 'profile' handling; an empty profiler stops profiling
+    void setProfiler(unique_ptr<CpuProfiler> profiler) {
+      myProfiler = std::move(profiler);
+    }
+    CpuProfiler* profiler() const { return myProfiler.get(); }
+
     void setGhostReadsTrap(bool enable) { myGhostReadsTrap = enable; }
     void setReadFromWritePortBreak(bool enable) { myReadFromWritePortBreak = enable; }
     void setWriteToReadPortBreak(bool enable) { myWriteToReadPortBreak = enable; }
@@ -328,7 +344,16 @@ class M6502 : public Serializable
     /**
       This is the actual dispatch function that does the grunt work. M6502::execute
       wraps it and makes sure that any pending halt is processed before returning.
+
+      By default, instructions are dispatched through a 'switch' statement.
+      Building with M6502_THREADED_DISPATCH (configure --enable-threaded-cpu)
+      uses a computed goto jump table instead (GCC/clang only).
+
+      The loop is instantiated with and without the per-instruction debugger
+      checks (breakpoints, traps, conditions, port access breaks); the latter
+      is used whenever none of those are armed.
     */
+    template<bool debugHooks>
     void _execute(uInt64 cycles, DispatchResult& result);
 
 #ifdef DEBUGGER_SUPPORT
@@ -337,6 +362,35 @@ class M6502 : public Serializable
       with the CPU and update the flag accordingly.
     */
     void updateStepStateByInstruction();
+
+    /**
+      Evaluate traps, breakpoints and conditional breaks before an instruction
+      is executed (and handle conditional savestates).
+
+      @return  True if execution must stop; the result has been updated
+    */
+    bool checkDebuggerBreak(uInt64 currentCycles, DispatchResult& result);
+
+    /**
+      Check for illegal read/write port accesses after an instruction.
+
+      @return  True if execution must stop; the result has been updated
+    */
+    bool checkPortAccessBreak(uInt64 currentCycles, uInt16 oldPC,
+                              DispatchResult& result);
+
+    /**
+      Answers whether any debugger feature requiring checks around every
+      instruction is currently armed.
+    */
+    bool debugHooksActive() const {
+      return myBreakPoints.size() > 0 ||
+             myReadTraps.isInitialized() || myWriteTraps.isInitialized() ||
+             myJustHitReadTrapFlag || myJustHitWriteTrapFlag ||
+             !myCondBreaks.empty() || !myCondSaveStates.empty() ||
+             myReadFromWritePortBreak || myWriteToReadPortBreak ||
+             myStepStateByInstruction || myTraceRecorder || myProfiler;
+    }
 #endif  // DEBUGGER_SUPPORT
 
   private:
@@ -457,12 +511,15 @@ class M6502 : public Serializable
     HitTrapInfo myHitTrapInfo;
 
     BreakpointMap myBreakPoints;
-    vector<unique_ptr<Expression>> myCondBreaks;
+    vector<unique_ptr<CompiledExpression>> myCondBreaks;
     StringList myCondBreakNames;
-    vector<unique_ptr<Expression>> myCondSaveStates;
+    vector<unique_ptr<CompiledExpression>> myCondSaveStates;
     StringList myCondSaveStateNames;
-    vector<unique_ptr<Expression>> myTrapConds;
+    vector<unique_ptr<CompiledExpression>> myTrapConds;
     StringList myTrapCondNames;
+
+    unique_ptr<TraceRecorder> myTraceRecorder;
+    unique_ptr<CpuProfiler> myProfiler;
 #endif  // DEBUGGER_SUPPORT
 
     bool myGhostReadsTrap{false};          // trap on ghost reads
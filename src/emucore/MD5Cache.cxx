@@ -0,0 +1,185 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "MD5.hxx"
+#include "MD5Cache.hxx"
+
+namespace {
+  // Number of files a worker claims at once
+  constexpr size_t BATCH_SIZE = 16;
+
+  // Interval of the progress callback
+  constexpr auto PROGRESS_INTERVAL = std::chrono::milliseconds(20);
+}
+
+std::mutex MD5Cache::myZipMutex;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MD5Cache::MD5Cache(const FilesystemNode& file)
+  : myFile{file}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MD5Cache::hash(const FilesystemNode& node)
+{
+  const string& path = node.getPath();
+  uInt64 size = 0, time = 0;
+  const bool cacheable = node.getFileInfo(size, time);
+
+  if(cacheable)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    load();
+    const auto iter = myEntries.find(path);
+    if(iter != myEntries.end() && iter->second.size == size &&
+       iter->second.time == time)
+      return iter->second.md5;
+  }
+
+  string md5;
+  if(BSPF::containsIgnoreCase(path, ".zip"))
+  {
+    std::lock_guard<std::mutex> lock(myZipMutex);
+    md5 = MD5::hash(node);
+  }
+  else
+    md5 = MD5::hash(node);
+
+  if(cacheable && !md5.empty())
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myEntries[path] = Entry{size, time, md5};
+    myModified = true;
+  }
+
+  return md5;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StringList MD5Cache::hash(const FSList& files,
+                          const std::function<bool(size_t)>& progress)
+{
+  StringList digests(files.size());
+  std::atomic<size_t> next{0}, done{0};
+  std::atomic<bool> cancelled{false};
+
+  const auto work = [&]() {
+    for(size_t first = next.fetch_add(BATCH_SIZE); first < files.size();
+        first = next.fetch_add(BATCH_SIZE))
+    {
+      const size_t last = std::min(first + BATCH_SIZE, files.size());
+
+      for(size_t i = first; i < last && !cancelled; ++i)
+        if(files[i].isFile())
+          digests[i] = hash(files[i]);
+
+      done += last - first;
+    }
+  };
+
+  const size_t batches = (files.size() + BATCH_SIZE - 1) / BATCH_SIZE;
+  const size_t jobs = std::min<size_t>(
+      std::max(std::thread::hardware_concurrency(), 1U), batches);
+
+  vector<std::thread> workers;
+  workers.reserve(jobs);
+  for(size_t i = 0; i < jobs; ++i)
+    workers.emplace_back(work);
+
+  while(done < files.size())
+  {
+    if(!progress(done))
+    {
+      cancelled = true;
+      break;
+    }
+    std::this_thread::sleep_for(PROGRESS_INTERVAL);
+  }
+
+  for(auto& worker: workers)
+    worker.join();
+
+  if(!cancelled)
+    progress(files.size());
+
+  return digests;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MD5Cache::save()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  if(!myModified)
+    return true;
+
+  // One entry per line: the digest, the size and the time, and the path
+  stringstream out;
+  for(const auto& [path, entry]: myEntries)
+    out << entry.md5 << ' ' << entry.size << ' ' << entry.time << ' '
+        << path << '\n';
+
+  try
+  {
+    myFile.write(out);
+  }
+  catch(...)
+  {
+    return false;
+  }
+
+  myModified = false;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MD5Cache::load()
+{
+  if(myLoaded)
+    return;
+  myLoaded = true;
+
+  stringstream in;
+  try
+  {
+    if(!myFile.exists() || myFile.read(in) == 0)
+      return;
+  }
+  catch(...)
+  {
+    return;
+  }
+
+  string line;
+  while(std::getline(in, line))
+  {
+    istringstream buf(line);
+    Entry entry;
+    string path;
+
+    if(buf >> entry.md5 >> entry.size >> entry.time && buf.get() == ' ' &&
+       std::getline(buf, path) && entry.md5.length() == 32 && !path.empty())
+      myEntries.emplace(path, std::move(entry));
+  }
+}
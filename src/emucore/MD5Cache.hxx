@@ -0,0 +1,113 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MD5_CACHE_HXX
+#define MD5_CACHE_HXX
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "FSNode.hxx"
+#include "bspf.hxx"
+
+/**
+  A persistent cache of the MD5 digests of ROM files, keyed by the path of
+  each file.  An entry is only used while the size and the modification
+  time of its file are unchanged, so re-hashing unchanged ROM collections
+  is (almost) free.
+
+  The cache file is loaded on first use, and only written when something
+  has changed.  All methods are thread-safe.
+
+  @author  Stella Team
+*/
+class MD5Cache
+{
+  public:
+    /**
+      Create a cache which is stored in the given file.
+    */
+    explicit MD5Cache(const FilesystemNode& file);
+    ~MD5Cache() = default;
+
+    /**
+      Get the MD5 digest of the given file, from the cache if possible.
+
+      @param node  The file to get the digest of
+      @return  The digest, or an empty string if the file cannot be read
+    */
+    string hash(const FilesystemNode& node);
+
+    /**
+      Get the MD5 digests of the given files, using all available CPU cores.
+
+      While the files are hashed, 'progress' is periodically called on the
+      calling thread with the number of files processed so far; it returns
+      false to cancel the remaining files.
+
+      @param files     The files to get the digests of
+      @param progress  The progress callback
+      @return  The digests, in the same order as 'files'; the digests of
+               unreadable or cancelled files are empty
+    */
+    StringList hash(const FSList& files, const std::function<bool(size_t)>& progress);
+
+    /**
+      Write the cache file, if the cache has changed since it was loaded.
+
+      @return  False if the file could not be written
+    */
+    bool save();
+
+  private:
+    // A cached digest, and the state of the file it belongs to
+    struct Entry {
+      uInt64 size{0};
+      uInt64 time{0};
+      string md5;
+    };
+
+    /**
+      Load the cache file, unless it has been loaded already.
+      The caller must hold 'myMutex'.
+    */
+    void load();
+
+  private:
+    FilesystemNode myFile;
+
+    std::unordered_map<string, Entry> myEntries;
+    bool myLoaded{false};
+    bool myModified{false};
+
+    std::mutex myMutex;
+
+    // Files inside of ZIP archives are read through a shared handler,
+    // which can only be used by one thread at a time
+    static std::mutex myZipMutex;
+
+  private:
+    // Following constructors and assignment operators not supported
+    MD5Cache() = delete;
+    MD5Cache(const MD5Cache&) = delete;
+    MD5Cache(MD5Cache&&) = delete;
+    MD5Cache& operator=(const MD5Cache&) = delete;
+    MD5Cache& operator=(MD5Cache&&) = delete;
+};
+
+#endif
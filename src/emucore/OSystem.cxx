@@ -53,6 +53,7 @@
 #include "TIAConstants.hxx"
 #include "Settings.hxx"
 #include "PropsSet.hxx"
+#include "MD5Cache.hxx"
 #include "EventHandler.hxx"
 #include "PNGLibrary.hxx"
 #include "Console.hxx"
@@ -199,6 +200,7 @@ bool OSystem::create()
 #endif
 
   myPropSet->load(myPropertiesFile);
+  myMD5Cache = make_unique<MD5Cache>(myMD5CacheFile);
 
   // Detect serial port for AtariVox-USB
   // If a previously set port is defined, use it;
@@ -269,6 +271,9 @@ void OSystem::saveConfig()
 
   if(myPropSet && myPropSet->save(myPropertiesFile))
     Logger::debug("Saving properties set ...");
+
+  if(myMD5Cache && !myMD5Cache->save())
+    Logger::error("ERROR: Couldn't save ROM digest cache " + myMD5CacheFile.getShortPath());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -313,6 +318,7 @@ void OSystem::setConfigPaths()
   myCheatFile = myBaseDir;  myCheatFile /= "stella.cht";
   myPaletteFile = myBaseDir;  myPaletteFile /= "stella.pal";
   myPropertiesFile = myBaseDir;  myPropertiesFile /= "stella.pro";
+  myMD5CacheFile = myBaseDir;  myMD5CacheFile /= "stella.md5";
 
 #if 0
   // Debug code
@@ -329,6 +335,7 @@ void OSystem::setConfigPaths()
   dbgPath("cheat file", myCheatFile);
   dbgPath("pal file  ", myPaletteFile);
   dbgPath("pro file  ", myPropertiesFile);
+  dbgPath("md5 file  ", myMD5CacheFile);
   dbgPath("INI file  ", myConfigFile);
 #endif
 }
@@ -23,6 +23,7 @@ class FrameBuffer;
 class EventHandler;
 class Properties;
 class PropertiesSet;
+class MD5Cache;
 class Random;
 class Sound;
 class StateManager;
@@ -134,6 +135,13 @@ class OSystem
     */
     PropertiesSet& propSet() const { return *myPropSet; }
 
+    /**
+      Get the cache of ROM file digests for the system.
+
+      @return The MD5 cache object
+    */
+    MD5Cache& md5Cache() const { return *myMD5Cache; }
+
     /**
       Get the console of the system.  The console won't always exist,
       so we should test if it's available.
@@ -492,6 +500,9 @@ class OSystem
     // Pointer to the PropertiesSet object
     unique_ptr<PropertiesSet> myPropSet;
 
+    // Pointer to the MD5Cache object
+    unique_ptr<MD5Cache> myMD5Cache;
+
     // Pointer to the (currently defined) Console object
     unique_ptr<Console> myConsole;
 
@@ -553,7 +564,8 @@ class OSystem
   private:
     FilesystemNode myBaseDir, myStateDir, mySnapshotSaveDir, mySnapshotLoadDir,
                    myNVRamDir, myCfgDir, myDefaultSaveDir, myDefaultLoadDir;
-    FilesystemNode myCheatFile, myConfigFile, myPaletteFile,  myPropertiesFile;
+    FilesystemNode myCheatFile, myConfigFile, myPaletteFile,  myPropertiesFile,
+                   myMD5CacheFile;
     FilesystemNode myRomFile;  string myRomMD5;
 
     string myFeatures;
@@ -24,6 +24,69 @@
 #include "Props.hxx"
 #include "PropsSet.hxx"
 
+namespace {
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  bool md5ToWords(const string& md5, std::array<uInt32, 4>& words)
+  {
+    if(md5.length() != 32)
+      return false;
+
+    for(uInt32 i = 0; i < 32; ++i)
+    {
+      const char c = md5[i];
+      uInt32 nibble;
+
+      if(c >= '0' && c <= '9')       nibble = c - '0';
+      else if(c >= 'a' && c <= 'f')  nibble = c - 'a' + 10;
+      else if(c >= 'A' && c <= 'F')  nibble = c - 'A' + 10;
+      else                           return false;
+
+      words[i >> 3] = (words[i >> 3] << 4) | nibble;
+    }
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  string wordsToMD5(const std::array<uInt32, 4>& words)
+  {
+    static constexpr char HEX[] = "0123456789abcdef";
+    string md5(32, '0');
+
+    for(uInt32 i = 0; i < 32; ++i)
+      md5[i] = HEX[(words[i >> 3] >> (28 - (i & 7) * 4)) & 0x0f];
+
+    return md5;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  const DefPropsEntry* findDefProps(const string& md5)
+  {
+    std::array<uInt32, 4> words{0};
+    if(!md5ToWords(md5, words))
+      return nullptr;
+
+    // The built-in properties are stored using a minimal perfect hash
+    // (see create_props.pl): the first word selects a bucket, whose
+    // displacement either is the slot itself, or is mixed with the
+    // second word to get the slot
+    const Int32 d = DefPropsHash[words[0] % DEF_PROPS_SIZE];
+    const uInt32 slot = d < 0 ? uInt32(-d - 1)
+      : ((words[1] ^ uInt32(d)) * 0x9E3779B1) % DEF_PROPS_SIZE;
+
+    return DefProps[slot].md5 == words ? &DefProps[slot] : nullptr;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  void copyDefProps(const DefPropsEntry& entry, Properties& properties)
+  {
+    properties.set(PropType::Cart_MD5, wordsToMD5(entry.md5));
+
+    for(uInt32 i = entry.firstField; i < entry.firstField + entry.numFields; ++i)
+      properties.set(PropType(DefPropsFields[i].type),
+                     DefPropsStrings[DefPropsFields[i].value]);
+  }
+} // namespace
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::load(const FilesystemNode& file, bool save)
 {
@@ -51,10 +114,19 @@ bool PropertiesSet::save(const FilesystemNode& file) const
     if(!file.exists() && myExternalProps.size() == 0)
       return false;
 
-    // Only save those entries in the external list
-    stringstream out;
+    // Only save those entries in the external list, sorted by md5
+    vector<const PropsList::value_type*> entries;
+    entries.reserve(myExternalProps.size());
     for(const auto& i: myExternalProps)
-      out << i.second;
+      entries.push_back(&i);
+    std::sort(entries.begin(), entries.end(),
+      [](const PropsList::value_type* a, const PropsList::value_type* b) {
+        return a->first < b->first;
+      });
+
+    stringstream out;
+    for(const auto* i: entries)
+      out << i->second;
 
     file.write(out);
     return true;
@@ -106,29 +178,14 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
     }
   }
 
-  // Otherwise, search the internal database using binary search
+  // Otherwise, search the internal database
   if(!found)
   {
-    int low = 0, high = DEF_PROPS_SIZE - 1;
-    while(low <= high)
+    const DefPropsEntry* entry = findDefProps(md5);
+    if(entry != nullptr)
     {
-      int i = (low + high) / 2;
-      int cmp = BSPF::compareIgnoreCase(md5,
-          DefProps[i][static_cast<uInt8>(PropType::Cart_MD5)]);
-
-      if(cmp == 0)  // found it
-      {
-        for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
-          if(DefProps[i][p][0] != 0)
-            properties.set(PropType(p), DefProps[i][p]);
-
-        found = true;
-        break;
-      }
-      else if(cmp < 0)
-        high = i - 1; // look at lower range
-      else
-        low = i + 1;  // look at upper range
+      copyDefProps(*entry, properties);
+      found = true;
     }
   }
 
@@ -216,21 +273,19 @@ void PropertiesSet::print() const
   // This isn't fast, but I suspect this method isn't used too often (or at all)
 
   // First insert all external props
-  PropsList list = myExternalProps;
+  std::map<string, Properties> list(myExternalProps.begin(), myExternalProps.end());
 
   // Now insert all the built-in ones
   // Note that if we try to insert a duplicate, the insertion will fail
   // This is fine, since a duplicate in the built-in list means it should
   // be overrided anyway (and insertion shouldn't be done)
   Properties properties;
-  for(uInt32 i = 0; i < DEF_PROPS_SIZE; ++i)
+  for(const auto& entry: DefProps)
   {
     properties.setDefaults();
-    for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
-      if(DefProps[i][p][0] != 0)
-        properties.set(PropType(p), DefProps[i][p]);
+    copyDefProps(entry, properties);
 
-    list.emplace(DefProps[i][static_cast<uInt8>(PropType::Cart_MD5)], properties);
+    list.emplace(properties.get(PropType::Cart_MD5), properties);
   }
 
   // Now, print the resulting list
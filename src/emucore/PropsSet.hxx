@@ -18,7 +18,7 @@
 #ifndef PROPERTIES_SET_HXX
 #define PROPERTIES_SET_HXX
 
-#include <map>
+#include <unordered_map>
 
 class FilesystemNode;
 class OSystem;
@@ -27,8 +27,8 @@ class OSystem;
 #include "Props.hxx"
 
 /**
-  This class maintains an ordered collection of properties, maintained
-  in a C++ map and accessible by ROM md5.  The md5 is used since this is
+  This class maintains a collection of properties, maintained in a C++
+  hash map and accessible by ROM md5.  The md5 is used since this is
   the attribute which must be present in each entry in stella.pro
   and least likely to change.  A change in MD5 would mean a change in
   the game rom image (essentially a different game) and this would
@@ -111,7 +111,7 @@ class PropertiesSet
     void print() const;
 
   private:
-    using PropsList = std::map<string, Properties>;
+    using PropsList = std::unordered_map<string, Properties>;
 
     // The properties read from an external 'stella.pro' file
     PropsList myExternalProps;
@@ -53,6 +53,24 @@ class Serializable
       @return  False on any errors, else true
     */
     virtual bool load(Serializer& in) = 0;
+
+    /**
+      Get the exact number of bytes save() currently writes, without
+      storing any of them.
+
+      @return  The size of the state, or 0 on any errors
+    */
+    virtual size_t stateSize() const {
+      Serializer out(Serializer::SizeOnly{});
+      return save(out) ? out.size() : 0;
+    }
+
+    /**
+      Get an upper bound for stateSize(), which holds for as long as the
+      object isn't reconfigured (e.g. by loading another ROM).  Objects
+      whose state changes its size while running must override this.
+    */
+    virtual size_t maxStateSize() const { return stateSize(); }
 };
 
 #endif
@@ -25,6 +25,10 @@
   read from/written to a binary stream in a system-independent way.  The
   stream can be either an actual file, or an in-memory structure.
 
+  In-memory data is kept in a flat byte buffer, which either grows as
+  needed, or is provided by the caller and used in place (without any
+  copying).
+
   Bytes are written as characters, shorts as 2 characters (16-bits),
   integers as 4 characters (32-bits), long integers as 8 bytes (64-bits),
   strings are written as characters prepended by the length of the string,
@@ -52,12 +56,36 @@ class Serializer
     explicit Serializer(const string& filename, Mode m = Mode::ReadWrite);
     Serializer();
 
+    /**
+      Creates a new in-memory Serializer device, which works directly on the
+      given buffer of 'size' bytes.  The buffer must outlive the device, and
+      can never grow; trying to read or write beyond its end throws.
+
+      In read-only mode, the buffer contents are the data to be read.  In
+      read/write mode, the existing contents are kept and can be overwritten,
+      while in truncate mode the device starts empty.
+    */
+    Serializer(uInt8* buffer, size_t size, Mode m);
+
+    /**
+      Creates a new read-only in-memory Serializer device on the given data,
+      without copying it.
+    */
+    Serializer(const uInt8* data, size_t size);
+
+    /**
+      Creates a new Serializer device which stores nothing, but only counts
+      the bytes written to it (see size()).  It can never be read from.
+    */
+    struct SizeOnly { };
+    explicit Serializer(SizeOnly);
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const { return myStream != nullptr || myInMemory; }
 
     /**
       Resets the read/write location to the beginning of the stream.
@@ -69,6 +97,11 @@ class Serializer
     */
     size_t size() const;
 
+    /**
+      Returns the in-memory data (size() bytes), or nullptr for a file.
+    */
+    const uInt8* data() const { return myData; }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -216,9 +249,33 @@ class Serializer
     void putBool(bool b);
 
   private:
-    // The stream to send the serialized data to.
+    /**
+      Read/write raw bytes from/to either the file or the memory buffer.
+    */
+    void read(void* dst, size_t size) const;
+    void write(const void* src, size_t size);
+
+    /**
+      Make room for at least 'size' bytes of in-memory data.
+    */
+    void reserve(size_t size);
+
+  private:
+    // The stream to send the serialized data to, when using a file
     unique_ptr<iostream> myStream;
 
+    // The in-memory data; points into 'myBuffer', unless an external
+    // buffer is used
+    ByteArray myBuffer;
+    uInt8* myData{nullptr};
+    size_t myCapacity{0};
+    size_t mySize{0};
+    size_t myWritePos{0};
+    mutable size_t myReadPos{0};
+    bool myInMemory{false};
+    bool myExternal{false};
+    bool mySizeOnly{false};
+
     static constexpr uInt8 TruePattern = 0xfe, FalsePattern = 0x01;
 
   private:
@@ -130,6 +130,7 @@ Settings::Settings()
   setPermanent("sssingle", "false");
   setPermanent("ss1x", "false");
   setPermanent("ssinterval", "2");
+  setPermanent("sscompression", "6");
   setPermanent("autoslot", "false");
   setPermanent("saveonexit", "none");
 
@@ -174,6 +175,7 @@ Settings::Settings()
   setPermanent("avoxport", "");
   setPermanent("fastscbios", "true");
   setPermanent("threads", "false");
+  setPermanent("threadcount", "0");
   setTemporary("romloadcount", "0");
   setTemporary("maxres", "");
   setPermanent("initials", "");
@@ -208,6 +210,7 @@ Settings::Settings()
   setPermanent("plr.tm.uncompressed", 60);
   setPermanent("plr.tm.interval", "30f"); // = 0.5 seconds
   setPermanent("plr.tm.horizon", "10m"); // = ~10 minutes
+  setPermanent("plr.tm.memory", 0); // in MB, 0 = unlimited
   setPermanent("plr.detectedinfo", "false");
   setPermanent("plr.eepromaccess", "false");
 
@@ -237,6 +240,7 @@ Settings::Settings()
   setPermanent("dev.tm.uncompressed", 600);
   setPermanent("dev.tm.interval", "1f"); // = 1 frame
   setPermanent("dev.tm.horizon", "30s"); // = ~30 seconds
+  setPermanent("dev.tm.memory", 0); // in MB, 0 = unlimited
   // Thumb ARM emulation options
   setPermanent("dev.thumb.trapfatal", "true");
   setPermanent("dev.detectedinfo", "true");
@@ -293,6 +297,9 @@ void Settings::validate()
   s = getString("tv.phosphor");
   if(s != "always" && s != "byrom")  setValue("tv.phosphor", "byrom");
 
+  i = getInt("threadcount");
+  if(i < 0)  setValue("threadcount", "0");
+
   i = getInt("tv.phosblend");
   if(i < 0 || i > 100)  setValue("tv.phosblend", "50");
 
@@ -318,6 +325,9 @@ void Settings::validate()
   i = getInt("dev.tm.horizon");
   if(i < 0 || i > 6) setValue("dev.tm.horizon", 1);*/
 
+  i = getInt("dev.tm.memory");
+  if(i < 0) setValue("dev.tm.memory", 0);
+
   i = getInt("plr.tv.jitter_recovery");
   if(i < 1 || i > 20) setValue("plr.tv.jitter_recovery", "10");
 
@@ -337,6 +347,9 @@ void Settings::validate()
   i = getInt("plr.tm.horizon");
   if(i < 0 || i > 6) setValue("plr.tm.horizon", 5);*/
 
+  i = getInt("plr.tm.memory");
+  if(i < 0) setValue("plr.tm.memory", 0);
+
 #ifdef SOUND_SUPPORT
   AudioSettings::normalize(*this);
 #endif
@@ -373,6 +386,9 @@ void Settings::validate()
   if(i < 1)        setValue("ssinterval", "2");
   else if(i > 10)  setValue("ssinterval", "10");
 
+  i = getInt("sscompression");
+  if(i < 0 || i > 9)  setValue("sscompression", "6");
+
   s = getString("palette");
   if(s != PaletteHandler::SETTING_STANDARD
      && s != PaletteHandler::SETTING_Z26
@@ -514,6 +530,8 @@ void Settings::usage() const
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
     << "  -threads      <1|0>          Whether to using multi-threading during\n"
     << "                                emulation\n"
+    << "  -threadcount  <number>       Number of threads used for multi-threaded\n"
+    << "                                rendering (0 means automatic)\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
     << "  -snaploaddir  <path>         The directory to load snapshot files from\n"
     << "  -snapname     <int|rom>      Name snapshots according to internal database or\n"
@@ -523,6 +541,8 @@ void Settings::usage() const
     << "                                scaling/effects)\n"
     << "  -ssinterval   <number>       Number of seconds between snapshots in\n"
     << "                                continuous snapshot mode\n"
+    << "  -sscompression <0-9>         Compression level of snapshots (0 = none,\n"
+    << "                                9 = smallest/slowest)\n"
     << endl
     << "  -saveonexit   <none|current| Automatically save state(s) when exiting\n"
     << "                 all>           emulation\n"
@@ -532,6 +552,10 @@ void Settings::usage() const
     << "  -rominfo      <rom>          Display detailed information for the given ROM\n"
     << "  -listrominfo                 Display contents of stella.pro, one line per ROM\n"
     << "                                entry\n"
+    << "  -batch [-jobs <number>]      Emulate the given ROMs (or all ROMs in the given\n"
+    << "    [-frames <number>]          directories) without video and audio, on\n"
+    << "    [-cycles <number>]          several threads, and print the results as\n"
+    << "    [-out <file>] <rom|dir>...  JSON (to stdout or 'file'), then exit\n"
     << endl
     << "  -exitlauncher <1|0>          On exiting a ROM, go back to the ROM launcher\n"
     << "  -launcherpos  <XxY>          Sets the window position in windowed EOM launcher mode\n"
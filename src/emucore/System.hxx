@@ -306,6 +306,19 @@ class System : public Serializable
       myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT] = access;
     }
 
+    /**
+      Set the page accessing methods for a number of consecutive pages at
+      once, starting with the page of the specified address.
+
+      @param addr    The address of the first page
+      @param access  The accessing methods to be used by the pages
+      @param count   The number of pages
+    */
+    void setPageAccess(uInt16 addr, const PageAccess* access, size_t count) {
+      std::copy_n(access, count,
+                  myPageAccessTable.begin() + ((addr & ADDRESS_MASK) >> PAGE_SHIFT));
+    }
+
     /**
       Get the page accessing method for the specified address.
 
@@ -24,6 +24,7 @@
 #include "TIA.hxx"
 #include "PNGLibrary.hxx"
 #include "PaletteHandler.hxx"
+#include "RenderKernels.hxx"
 #include "TIASurface.hxx"
 
 namespace {
@@ -89,7 +90,8 @@ TIASurface::TIASurface(OSystem& system)
   myRGBFramebuffer.fill(0);
 
   // Enable/disable threading in the NTSC TV effects renderer
-  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"));
+  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"),
+                               myOSystem.settings().getInt("threadcount"));
 
   myPaletteHandler = make_unique<PaletteHandler>(myOSystem);
   myPaletteHandler->loadConfig(myOSystem.settings());
@@ -348,29 +350,6 @@ string TIASurface::effectsInfo() const
   return buf.str();
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline uInt32 TIASurface::averageBuffers(uInt32 bufOfs)
-{
-  const uInt32 c = myRGBFramebuffer[bufOfs];
-  const uInt32 p = myPrevRGBFramebuffer[bufOfs];
-
-  // Split into RGB values
-  const uInt8 rc = static_cast<uInt8>(c >> 16),
-              gc = static_cast<uInt8>(c >> 8),
-              bc = static_cast<uInt8>(c),
-              rp = static_cast<uInt8>(p >> 16),
-              gp = static_cast<uInt8>(p >> 8),
-              bp = static_cast<uInt8>(p);
-
-  // Mix current calculated buffer with previous calculated buffer (50:50)
-  const uInt8 rn = (rc + rp) / 2;
-  const uInt8 gn = (gc + gp) / 2;
-  const uInt8 bn = (bc + bp) / 2;
-
-  // return averaged value
-  return (rn << 16) | (gn << 8) | bn;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::render(bool shade)
 {
@@ -383,17 +362,13 @@ void TIASurface::render(bool shade)
   {
     case Filter::Normal:
     {
-      uInt8* tiaIn = myTIA->frameBuffer();
+      const uInt8* tiaIn = myTIA->frameBuffer();
 
-      uInt32 bufofs = 0, screenofsY = 0, pos;
-      for(uInt32 y = 0; y < height; ++y)
+      uInt32 bufofs = 0, screenofsY = 0;
+      for(uInt32 y = height; y; --y)
       {
-        pos = screenofsY;
-        for (uInt32 x = width / 2; x; --x)
-        {
-          out[pos++] = myPalette[tiaIn[bufofs++]];
-          out[pos++] = myPalette[tiaIn[bufofs++]];
-        }
+        RenderKernels::expandPalette(tiaIn + bufofs, out + screenofsY, width, myPalette);
+        bufofs += width;
         screenofsY += outPitch;
       }
       break;
@@ -401,25 +376,24 @@ void TIASurface::render(bool shade)
 
     case Filter::Phosphor:
     {
-      uInt8*  tiaIn = myTIA->frameBuffer();
+      const uInt8* tiaIn = myTIA->frameBuffer();
       uInt32* rgbIn = myRGBFramebuffer.data();
+      const float decay = PhosphorHandler::decay();
 
       if (mySaveSnapFlag)
         std::copy_n(myRGBFramebuffer.begin(), width * height,
                     myPrevRGBFramebuffer.begin());
 
-      uInt32 bufofs = 0, screenofsY = 0, pos;
+      uInt32 bufofs = 0, screenofsY = 0;
       for(uInt32 y = height; y ; --y)
       {
-        pos = screenofsY;
-        for(uInt32 x = width / 2; x ; --x)
-        {
-          // Store back into displayed frame buffer (for next frame)
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-        }
+        // Expand the colors into the output row, then blend them with the
+        // displayed frame buffer and store the result in both (the latter
+        // for the next frame)
+        uInt32* row = out + screenofsY;
+        RenderKernels::expandPalette(tiaIn + bufofs, row, width, myPalette);
+        RenderKernels::blendPhosphor(row, rgbIn + bufofs, row, width, decay);
+        bufofs += width;
         screenofsY += outPitch;
       }
       break;
@@ -475,7 +449,6 @@ void TIASurface::renderForSnapshot()
 
   uInt32 width = myTIA->width();
   uInt32 height = myTIA->height();
-  uInt32 pos = 0;
   uInt32 *outPtr, outPitch;
 
   myTiaSurface->basePtr(outPtr, outPitch);
@@ -495,22 +468,17 @@ void TIASurface::renderForSnapshot()
       uInt32 bufofs = 0, screenofsY = 0;
       for(uInt32 y = height; y; --y)
       {
-        pos = screenofsY;
-        for(uInt32 x = width / 2; x; --x)
-        {
-          outPtr[pos++] = averageBuffers(bufofs++);
-          outPtr[pos++] = averageBuffers(bufofs++);
-        }
+        RenderKernels::averagePixels(myRGBFramebuffer.data() + bufofs,
+            myPrevRGBFramebuffer.data() + bufofs, outPtr + screenofsY, width);
+        bufofs += width;
         screenofsY += outPitch;
       }
       break;
     }
 
     case Filter::BlarggPhosphor:
-      uInt32 bufofs = 0;
-      for(uInt32 y = height; y; --y)
-        for(uInt32 x = outPitch; x; --x)
-          outPtr[pos++] = averageBuffers(bufofs++);
+      RenderKernels::averagePixels(myRGBFramebuffer.data(),
+          myPrevRGBFramebuffer.data(), outPtr, height * outPitch);
       break;
   }
 
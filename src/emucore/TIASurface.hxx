@@ -184,11 +184,6 @@ class TIASurface
     void updateSurfaceSettings();
 
   private:
-    /**
-      Average current calculated buffer's pixel with previous calculated buffer's pixel (50:50).
-    */
-    uInt32 averageBuffers(uInt32 bufOfs);
-
     // Is plain video mode enabled?
     bool correctAspect() const;
 
@@ -0,0 +1,1187 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "ThumbDynarec.hxx"
+
+#ifdef THUMB_DYNAREC
+
+#if defined(BSPF_WINDOWS) || defined(_WIN32)
+  #define WIN64_ABI
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+#endif
+#ifdef THUMB_DYNAREC_LOCKSTEP
+  #include <map>
+  #include "Base.hxx"
+#endif
+
+namespace {
+  // Size of the executable memory; once it is full, all translations
+  // are discarded
+  constexpr size_t CODE_SIZE = 4096_KB;
+
+  // Space which is always sufficient for translating a block
+  constexpr size_t MAX_BLOCK_SIZE = 32_KB;
+
+  constexpr uInt32 MAX_BLOCK_LENGTH = 64;
+
+  // Number of executions before a block is translated
+  constexpr uInt8 HOT_BLOCK = 8;
+  constexpr uInt8 NEVER_HOT = 0xFF;
+
+  // The instruction limit of Thumbulator::run()
+  constexpr uInt64 MAX_INSTRUCTIONS = 500000;
+
+  // x86-64 opcodes of the ALU operations on two registers...
+  constexpr uInt8 ADD = 0x01, OR = 0x09, ADC = 0x11, AND = 0x21, SUB = 0x29,
+                  XOR = 0x31, CMP = 0x39, TEST = 0x85, MOV = 0x89;
+  // ... and the extensions for immediate operands and shifts
+  constexpr uInt8 ADD_I = 0, OR_I = 1, AND_I = 4, SUB_I = 5, XOR_I = 6, CMP_I = 7,
+                  SHL_I = 4, SHR_I = 5, SAR_I = 7;
+  // ... and the opcodes of MOVZX/MOVSX
+  constexpr uInt8 MOVZX8 = 0xB6, MOVZX16 = 0xB7, MOVSX8 = 0xBE, MOVSX16 = 0xBF;
+
+  constexpr uInt32 CPSR_NZ = CPSR_N | CPSR_Z, CPSR_NZC = CPSR_NZ | CPSR_C,
+                   CPSR_NZCV = CPSR_NZC | CPSR_V;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbDynarec::ThumbDynarec(Thumbulator& thumb)
+  : myThumb{thumb},
+    myEntries(thumb.romSize / 2)
+{
+#ifdef WIN64_ABI
+  void* code = VirtualAlloc(nullptr, CODE_SIZE, MEM_COMMIT | MEM_RESERVE,
+                            PAGE_EXECUTE_READWRITE);
+#else
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  #ifdef MAP_JIT
+  flags |= MAP_JIT;
+  #endif
+  void* code = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                    flags, -1, 0);
+  if(code == MAP_FAILED)
+    code = nullptr;
+#endif
+
+  myCode = myPos = static_cast<uInt8*>(code);
+  myEnd = myCode + CODE_SIZE;
+
+  myRegOffset = offsetOf(myThumb.reg_norm.data());
+  myCpsrOffset = offsetOf(&myThumb.cpsr);
+  myInstructionsOffset = offsetOf(&myThumb.instructions);
+#ifndef NO_THUMB_STATS
+  myFetchesOffset = offsetOf(&myThumb.fetches);
+  myReadsOffset = offsetOf(&myThumb.reads);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbDynarec::~ThumbDynarec()
+{
+  if(myCode)
+  {
+#ifdef WIN64_ABI
+    VirtualFree(myCode, 0, MEM_RELEASE);
+#else
+    munmap(myCode, CODE_SIZE);
+#endif
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThumbDynarec::execute(int& result)
+{
+  // Same as the ROM check in Thumbulator::execute()
+  const uInt32 addr = (myThumb.reg_norm[15] & ~1U) - 2;
+  if(addr >= myThumb.romSize || addr < 0x50)
+    return false;
+
+  Entry& entry = myEntries[addr >> 1];
+  if(entry.length == 0)
+  {
+    if(entry.heat == NEVER_HOT || ++entry.heat < HOT_BLOCK)
+      return false;
+    if(!translate(addr, entry))
+    {
+      entry.heat = NEVER_HOT;
+      return false;
+    }
+  }
+
+  // Let the interpreter run into the instruction limit
+  if(myThumb.instructions + entry.length > MAX_INSTRUCTIONS)
+    return false;
+
+#ifdef THUMB_DYNAREC_LOCKSTEP
+  result = verifyBlock(entry, addr);
+#else
+  result = runBlock(entry);
+#endif
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ThumbDynarec::runBlock(const Entry& entry)
+{
+  const Block block = reinterpret_cast<Block>(myCode + entry.offset);
+  const uInt32 result = block(&myThumb);
+
+  if(result == BLOCK_EXCEPTION)
+  {
+    std::exception_ptr exception = myException;
+    myException = nullptr;
+    std::rethrow_exception(exception);
+  }
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThumbDynarec::translate(uInt32 addr, Entry& entry)
+{
+  // Discard all translations when the memory is exhausted
+  if(size_t(myEnd - myPos) < MAX_BLOCK_SIZE)
+  {
+    for(auto& e: myEntries)
+      e = Entry();
+    myPos = myCode;
+  }
+
+  uInt8* start = myPos;
+  myExitJumps.clear();
+  myExceptionJumps.clear();
+  myPendingInstructions = 0;
+
+  // push rbx; sub rsp, 32; mov rbx, <first argument>
+  emit8(0x53);
+  emit8(0x48);  emit8(0x83);  emit8(0xEC);  emit8(0x20);
+#ifdef WIN64_ABI
+  emit8(0x48);  emit8(0x89);  emit8(0xCB);
+#else
+  emit8(0x48);  emit8(0x89);  emit8(0xFB);
+#endif
+
+  uInt32 length = 0, translated = 0;
+  bool pcUpdated = false;
+
+  for(uInt32 a = addr; length < MAX_BLOCK_LENGTH && a < myThumb.romSize; a += 2)
+  {
+    const Thumbulator::DecodedOp& op = myThumb.decodedRom[a >> 1];
+    ++length;
+
+    if(translateOp(op, a))
+    {
+      ++translated;
+      pcUpdated = op.op == Op::b1 || op.op == Op::b2;
+      if(pcUpdated)
+        break;
+    }
+    else
+    {
+      // Let the interpreter execute the instruction at the pc
+      flushCounters();
+      storeMemImm(myRegOffset + 15 * 4, a + 2);
+      callFunction(reinterpret_cast<const void*>(&interpret));
+      checkException();
+      aluReg(TEST, EAX, EAX);
+      myExitJumps.push_back(jumpCond(CC_NZ));
+
+      pcUpdated = true;
+      if(endsBlock(op))
+        break;
+    }
+  }
+
+  // Nothing to gain if (almost) everything is interpreted
+  if(translated < 2)
+  {
+    myPos = start;
+    return false;
+  }
+
+  flushCounters();
+  if(!pcUpdated)
+    storeMemImm(myRegOffset + 15 * 4, addr + length * 2 + 2);
+  aluReg(XOR, EAX, EAX);
+
+  // add rsp, 32; pop rbx; ret
+  for(uInt8* jump: myExitJumps)
+    patchJump(jump);
+  emit8(0x48);  emit8(0x83);  emit8(0xC4);  emit8(0x20);
+  emit8(0x5B);
+  emit8(0xC3);
+
+  // mov eax, BLOCK_EXCEPTION; add rsp, 32; pop rbx; ret
+  for(uInt8* jump: myExceptionJumps)
+    patchJump(jump);
+  movImm(EAX, BLOCK_EXCEPTION);
+  emit8(0x48);  emit8(0x83);  emit8(0xC4);  emit8(0x20);
+  emit8(0x5B);
+  emit8(0xC3);
+
+  entry.offset = uInt32(start - myCode);
+  entry.length = uInt8(length);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThumbDynarec::translateOp(const Thumbulator::DecodedOp& op, uInt32 addr)
+{
+  myAddr = addr;
+
+  // Code for an operation 'rd = rd <op> rm' (or 'rd = rn <op> rm')
+  const auto binary = [&](uInt8 opcode, uInt32 rd, uInt32 rn, uInt32 rm,
+                          uInt32 flags, bool invertCarry = false) {
+    loadReg(EAX, rn);
+    loadReg(ECX, rm);
+    aluReg(opcode, EAX, ECX);
+    if(opcode != CMP && opcode != TEST)
+      storeReg(rd, EAX);
+    storeFlags(flags, invertCarry);
+  };
+
+  // Code for an operation 'rd = rn <op> imm'
+  const auto immediate = [&](uInt8 ext, uInt32 rd, uInt32 rn, uInt32 imm,
+                             uInt32 flags, bool invertCarry = false) {
+    loadReg(EAX, rn);
+    aluImm(ext, EAX, imm);
+    if(ext != CMP_I)
+      storeReg(rd, EAX);
+    storeFlags(flags, invertCarry);
+  };
+
+  // Code for a load into rd from the address in ECX
+  const auto load = [&](uInt64 (*function)(Thumbulator*, uInt32), uInt32 rd) {
+    storeMemImm(myRegOffset + 15 * 4, myAddr + 4);
+    flushCounters();
+    callFunction(reinterpret_cast<const void*>(function), ECX);
+    checkException();
+    storeReg(rd, EAX);
+  };
+
+  // Code for a store of rd to the address in ECX
+  const auto store = [&](uInt64 (*function)(Thumbulator*, uInt32, uInt32), uInt32 rd) {
+    loadReg(EDX, rd);
+    storeMemImm(myRegOffset + 15 * 4, myAddr + 4);
+    flushCounters();
+    callFunction(reinterpret_cast<const void*>(function), ECX, EDX);
+    checkException();
+  };
+
+  // Load the address 'rn + imm' or 'rn + rm' into ECX
+  const auto addressImm = [&](uInt32 rn, uInt32 imm) {
+    loadReg(ECX, rn);
+    if(imm)
+      aluImm(ADD_I, ECX, imm);
+  };
+  const auto addressReg = [&](uInt32 rn, uInt32 rm) {
+    loadReg(ECX, rn);
+    loadReg(EDX, rm);
+    aluReg(ADD, ECX, EDX);
+  };
+
+  const uInt32 imm = uInt32(Int32(op.imm));
+
+  // Some instructions are only translated in their common forms
+  switch(op.op)
+  {
+    case Op::add4:  case Op::mov3:
+      if(op.rd == 15) return false;
+      break;
+    case Op::asr1:  case Op::lsr1:
+      if(imm == 0) return false;
+      break;
+    case Op::b1:
+      if(op.rd >= 0xE) return false;
+      break;
+    default:
+      break;
+  }
+
+  ++myPendingInstructions;
+
+  switch(op.op)
+  {
+    case Op::adc:
+      loadReg(EAX, op.rd);
+      loadReg(ECX, op.rm);
+      btMem(myCpsrOffset, 29);  // carry flag into CF
+      aluReg(ADC, EAX, ECX);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZCV);
+      return true;
+
+    case Op::add1:
+      immediate(ADD_I, op.rd, op.rn, imm, CPSR_NZCV);
+      return true;
+
+    case Op::add2:
+      immediate(ADD_I, op.rd, op.rd, imm, CPSR_NZCV);
+      return true;
+
+    case Op::add3:
+      binary(ADD, op.rd, op.rn, op.rm, CPSR_NZCV);
+      return true;
+
+    case Op::add4:
+      binary(ADD, op.rd, op.rd, op.rm, 0);
+      return true;
+
+    case Op::add5:
+      movImm(EAX, ((addr + 4) & ~3U) + imm);
+      storeReg(op.rd, EAX);
+      return true;
+
+    case Op::add6:
+      immediate(ADD_I, op.rd, 13, imm, 0);
+      return true;
+
+    case Op::add7:
+      immediate(ADD_I, 13, 13, imm, 0);
+      return true;
+
+    case Op::and_:
+      binary(AND, op.rd, op.rd, op.rm, CPSR_NZ);
+      return true;
+
+    case Op::asr1:
+      loadReg(EAX, op.rm);
+      shiftImm(SAR_I, EAX, uInt8(imm));
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZC);
+      return true;
+
+    case Op::b1:
+    {
+      // The branch is taken if the condition evaluates to non-zero, or
+      // to zero for the odd conditions
+      flushCounters();
+      loadMem(EAX, myCpsrOffset);
+      switch(op.rd >> 1)
+      {
+        case 0: aluImm(AND_I, EAX, CPSR_Z);  break;  // EQ/NE
+        case 1: aluImm(AND_I, EAX, CPSR_C);  break;  // CS/CC
+        case 2: aluImm(AND_I, EAX, CPSR_N);  break;  // MI/PL
+        case 3: aluImm(AND_I, EAX, CPSR_V);  break;  // VS/VC
+        case 4:                                      // HI/LS
+          aluImm(AND_I, EAX, CPSR_C | CPSR_Z);
+          aluImm(CMP_I, EAX, CPSR_C);
+          break;
+        case 5:                                      // GE/LT
+          aluReg(MOV, ECX, EAX);
+          shiftImm(SHL_I, ECX, 3);
+          aluReg(XOR, EAX, ECX);
+          aluImm(AND_I, EAX, CPSR_N);
+          break;
+        default:                                     // GT/LE
+          aluReg(MOV, ECX, EAX);
+          shiftImm(SHL_I, ECX, 3);
+          aluReg(XOR, ECX, EAX);
+          aluImm(AND_I, ECX, CPSR_N);
+          aluImm(AND_I, EAX, CPSR_Z);
+          aluReg(OR, EAX, ECX);
+          break;
+      }
+      // For HI/LS, GE/LT and GT/LE the sense of the result is reversed
+      const bool even = (op.rd & 1) == 0;
+      uInt8* taken = jumpCond(even != (op.rd >= 0x8) ? CC_NZ : CC_Z);
+
+      storeMemImm(myRegOffset + 15 * 4, addr + 4);
+      uInt8* done = jump();
+      patchJump(taken);
+      storeMemImm(myRegOffset + 15 * 4, addr + 4 + imm);
+      patchJump(done);
+      return true;
+    }
+
+    case Op::b2:
+      flushCounters();
+      storeMemImm(myRegOffset + 15 * 4, addr + 4 + imm);
+      return true;
+
+    case Op::bic:
+      loadReg(EAX, op.rd);
+      loadReg(ECX, op.rm);
+      aluImm(XOR_I, ECX, ~0U);
+      aluReg(AND, EAX, ECX);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZ);
+      return true;
+
+    case Op::cmn:
+      loadReg(EAX, op.rn);
+      loadReg(ECX, op.rm);
+      aluReg(ADD, EAX, ECX);
+      storeFlags(CPSR_NZCV);
+      return true;
+
+    case Op::cmp1:
+      immediate(CMP_I, 0, op.rn, imm, CPSR_NZCV, true);
+      return true;
+
+    case Op::cmp2:  case Op::cmp3:
+      binary(CMP, 0, op.rn, op.rm, CPSR_NZCV, true);
+      return true;
+
+    case Op::cpy:  case Op::mov3:
+      loadReg(EAX, op.rm);
+      storeReg(op.rd, EAX);
+      return true;
+
+    case Op::eor:
+      binary(XOR, op.rd, op.rd, op.rm, CPSR_NZ);
+      return true;
+
+    case Op::ldr1:
+      addressImm(op.rn, imm);
+      load(&load32, op.rd);
+      return true;
+
+    case Op::ldr2:
+      addressReg(op.rn, op.rm);
+      load(&load32, op.rd);
+      return true;
+
+    case Op::ldr3:
+    {
+      // Literals in ROM are constant
+      const uInt32 a = ((addr + 4) & ~3U) + imm;
+      if(a + 4 <= myThumb.romSize)
+      {
+        movImm(EAX, myThumb.rom[a >> 1] | (uInt32(myThumb.rom[(a >> 1) + 1]) << 16));
+        storeReg(op.rd, EAX);
+      #ifndef NO_THUMB_STATS
+        addMem64Imm(myReadsOffset, 2);
+      #endif
+      }
+      else
+      {
+        movImm(ECX, a);
+        load(&load32, op.rd);
+      }
+      return true;
+    }
+
+    case Op::ldr4:
+      addressImm(13, imm);
+      load(&load32, op.rd);
+      return true;
+
+    case Op::ldrb1:
+      addressImm(op.rn, imm);
+      load(&load8, op.rd);
+      return true;
+
+    case Op::ldrb2:
+      addressReg(op.rn, op.rm);
+      load(&load8, op.rd);
+      return true;
+
+    case Op::ldrh1:
+      addressImm(op.rn, imm);
+      load(&load16, op.rd);
+      return true;
+
+    case Op::ldrh2:
+      addressReg(op.rn, op.rm);
+      load(&load16, op.rd);
+      return true;
+
+    case Op::ldrsb:
+      addressReg(op.rn, op.rm);
+      load(&load8s, op.rd);
+      return true;
+
+    case Op::ldrsh:
+      addressReg(op.rn, op.rm);
+      load(&load16s, op.rd);
+      return true;
+
+    case Op::lsl1:
+      loadReg(EAX, op.rm);
+      if(imm)
+        shiftImm(SHL_I, EAX, uInt8(imm));
+      else
+        aluReg(TEST, EAX, EAX);
+      storeReg(op.rd, EAX);
+      storeFlags(imm ? CPSR_NZC : CPSR_NZ);
+      return true;
+
+    case Op::lsr1:
+      loadReg(EAX, op.rm);
+      shiftImm(SHR_I, EAX, uInt8(imm));
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZC);
+      return true;
+
+    case Op::mov1:
+      movImm(EAX, imm);
+      storeReg(op.rd, EAX);
+      loadMem(ECX, myCpsrOffset);
+      aluImm(AND_I, ECX, ~CPSR_NZ);
+      if(imm == 0)
+        aluImm(OR_I, ECX, CPSR_Z);
+      storeMem(myCpsrOffset, ECX);
+      return true;
+
+    case Op::mov2:
+      // TEST clears CF and OF, just like MOV(2) clears C and V
+      loadReg(EAX, op.rn);
+      aluReg(TEST, EAX, EAX);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZCV);
+      return true;
+
+    case Op::mul:
+      loadReg(EAX, op.rd);
+      loadReg(ECX, op.rm);
+      imul(EAX, ECX);
+      aluReg(TEST, EAX, EAX);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZ);
+      return true;
+
+    case Op::mvn:
+      loadReg(EAX, op.rm);
+      aluImm(XOR_I, EAX, ~0U);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZ);
+      return true;
+
+    case Op::neg:
+      loadReg(ECX, op.rm);
+      aluReg(XOR, EAX, EAX);
+      aluReg(SUB, EAX, ECX);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZCV, true);
+      return true;
+
+    case Op::orr:
+      binary(OR, op.rd, op.rd, op.rm, CPSR_NZ);
+      return true;
+
+    case Op::sbc:
+      // rd + ~rm + C
+      loadReg(EAX, op.rd);
+      loadReg(ECX, op.rm);
+      aluImm(XOR_I, ECX, ~0U);
+      btMem(myCpsrOffset, 29);
+      aluReg(ADC, EAX, ECX);
+      storeReg(op.rd, EAX);
+      storeFlags(CPSR_NZCV);
+      return true;
+
+    case Op::str1:
+      addressImm(op.rn, imm);
+      store(&store32, op.rd);
+      return true;
+
+    case Op::str2:
+      addressReg(op.rn, op.rm);
+      store(&store32, op.rd);
+      return true;
+
+    case Op::str3:
+      addressImm(13, imm);
+      store(&store32, op.rd);
+      return true;
+
+    case Op::strb1:
+      addressImm(op.rn, imm);
+      store(&store8, op.rd);
+      return true;
+
+    case Op::strb2:
+      addressReg(op.rn, op.rm);
+      store(&store8, op.rd);
+      return true;
+
+    case Op::strh1:
+      addressImm(op.rn, imm);
+      store(&store16, op.rd);
+      return true;
+
+    case Op::strh2:
+      addressReg(op.rn, op.rm);
+      store(&store16, op.rd);
+      return true;
+
+    case Op::sub1:
+      immediate(SUB_I, op.rd, op.rn, imm, CPSR_NZCV, true);
+      return true;
+
+    case Op::sub2:
+      immediate(SUB_I, op.rd, op.rd, imm, CPSR_NZCV, true);
+      return true;
+
+    case Op::sub3:
+      binary(SUB, op.rd, op.rn, op.rm, CPSR_NZCV, true);
+      return true;
+
+    case Op::sub4:
+      immediate(SUB_I, 13, 13, imm, 0);
+      return true;
+
+    case Op::sxtb:  case Op::sxth:  case Op::uxtb:  case Op::uxth:
+      loadReg(EAX, op.rm);
+      movExtend(op.op == Op::sxtb ? MOVSX8 : op.op == Op::sxth ? MOVSX16 :
+                op.op == Op::uxtb ? MOVZX8 : MOVZX16, EAX, EAX);
+      storeReg(op.rd, EAX);
+      return true;
+
+    case Op::tst:
+      binary(TEST, 0, op.rn, op.rm, CPSR_NZ);
+      return true;
+
+    default:
+      --myPendingInstructions;
+      return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThumbDynarec::endsBlock(const Thumbulator::DecodedOp& op)
+{
+  switch(op.op)
+  {
+    case Op::add4:  case Op::mov3:
+      return op.rd == 15;
+
+    case Op::pop:
+      return op.imm & 0x100;
+
+    case Op::blx1:  // the first half of BL only sets the link register
+      return (op.inst & 0x1800) != 0x1000;
+
+    case Op::b1:    case Op::b2:    case Op::bkpt:
+    case Op::blx2:  case Op::bx:    case Op::cps:   case Op::setend:
+    case Op::swi:   case Op::invalid:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::saveException(Thumbulator* thumb)
+{
+  thumb->myDynarec->myException = std::current_exception();
+  return uInt64(1) << 32;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::interpret(Thumbulator* thumb)
+{
+  try {
+    return thumb->execute() ? BLOCK_STOP : BLOCK_OK;
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::load32(Thumbulator* thumb, uInt32 addr)
+{
+  try {
+    return thumb->read32(addr);
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::load16(Thumbulator* thumb, uInt32 addr)
+{
+  try {
+    return thumb->read16(addr) & 0xFFFF;
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::load16s(Thumbulator* thumb, uInt32 addr)
+{
+  try {
+    return uInt32(Int32(Int16(thumb->read16(addr) & 0xFFFF)));
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::load8(Thumbulator* thumb, uInt32 addr)
+{
+  try {
+    uInt32 data = thumb->read16(addr & ~1U);
+    if(addr & 1)
+      data >>= 8;
+    return data & 0xFF;
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::load8s(Thumbulator* thumb, uInt32 addr)
+{
+  try {
+    uInt32 data = thumb->read16(addr & ~1U);
+    if(addr & 1)
+      data >>= 8;
+    return uInt32(Int32(Int8(data & 0xFF)));
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::store32(Thumbulator* thumb, uInt32 addr, uInt32 data)
+{
+  try {
+    thumb->write32(addr, data);
+    return 0;
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::store16(Thumbulator* thumb, uInt32 addr, uInt32 data)
+{
+  try {
+    thumb->write16(addr, data & 0xFFFF);
+    return 0;
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ThumbDynarec::store8(Thumbulator* thumb, uInt32 addr, uInt32 data)
+{
+  try {
+    // Same as STRB in Thumbulator::execute()
+    uInt32 word = thumb->read16(addr & ~1U);
+    if(addr & 1)
+    {
+      word &= 0x00FF;
+      word |= data << 8;
+    }
+    else
+    {
+      word &= 0xFF00;
+      word |= data & 0x00FF;
+    }
+    thumb->write16(addr & ~1U, word & 0xFFFF);
+    return 0;
+  }
+  catch(...) {
+    return saveException(thumb);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::emit32(uInt32 d)
+{
+  emit8(d & 0xFF);  emit8((d >> 8) & 0xFF);  emit8((d >> 16) & 0xFF);  emit8(d >> 24);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::emitRex(bool w, uInt8 reg, uInt8 rm, bool byteRegs)
+{
+  const uInt8 rex = 0x40 | (w ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0);
+
+  // Without a REX prefix, byte registers 4-7 would be AH, CH, DH and BH
+  if(rex != 0x40 || (byteRegs && rm >= ESP && rm <= EDI))
+    emit8(rex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::emitModRmMem(uInt8 reg, Int32 disp)
+{
+  // [rbx + disp32]
+  emit8(0x80 | ((reg & 7) << 3) | EBX);
+  emit32(uInt32(disp));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::loadReg(Reg reg, uInt32 armReg)
+{
+  // Reading the pc gives the address of the current instruction plus 4
+  if(armReg == 15)
+    movImm(reg, myAddr + 4);
+  else
+    loadMem(reg, myRegOffset + Int32(armReg * 4));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::storeReg(uInt32 armReg, Reg reg)
+{
+  storeMem(myRegOffset + Int32(armReg * 4), reg);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::loadMem(Reg reg, Int32 disp)
+{
+  emitRex(false, reg, EBX);
+  emit8(0x8B);
+  emitModRmMem(reg, disp);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::storeMem(Int32 disp, Reg reg)
+{
+  emitRex(false, reg, EBX);
+  emit8(0x89);
+  emitModRmMem(reg, disp);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::storeMemImm(Int32 disp, uInt32 imm)
+{
+  emit8(0xC7);
+  emitModRmMem(0, disp);
+  emit32(imm);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::addMem64Imm(Int32 disp, uInt32 imm)
+{
+  emit8(0x48);
+  if(imm < 0x80)
+  {
+    emit8(0x83);
+    emitModRmMem(ADD_I, disp);
+    emit8(uInt8(imm));
+  }
+  else
+  {
+    emit8(0x81);
+    emitModRmMem(ADD_I, disp);
+    emit32(imm);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::btMem(Int32 disp, uInt8 bit)
+{
+  emit8(0x0F);
+  emit8(0xBA);
+  emitModRmMem(4, disp);
+  emit8(bit);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::movImm(Reg reg, uInt32 imm)
+{
+  emitRex(false, 0, reg);
+  emit8(0xB8 | (reg & 7));
+  emit32(imm);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::aluReg(uInt8 opcode, Reg dst, Reg src)
+{
+  emitRex(false, src, dst);
+  emit8(opcode);
+  emit8(0xC0 | ((src & 7) << 3) | (dst & 7));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::aluImm(uInt8 ext, Reg dst, uInt32 imm)
+{
+  const bool byte = Int32(imm) >= -128 && Int32(imm) <= 127;
+
+  emitRex(false, 0, dst);
+  emit8(byte ? 0x83 : 0x81);
+  emit8(0xC0 | (ext << 3) | (dst & 7));
+  if(byte)
+    emit8(uInt8(imm));
+  else
+    emit32(imm);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::shiftImm(uInt8 ext, Reg reg, uInt8 count)
+{
+  emitRex(false, 0, reg);
+  emit8(0xC1);
+  emit8(0xC0 | (ext << 3) | (reg & 7));
+  emit8(count);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::imul(Reg dst, Reg src)
+{
+  emitRex(false, dst, src);
+  emit8(0x0F);
+  emit8(0xAF);
+  emit8(0xC0 | ((dst & 7) << 3) | (src & 7));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::movExtend(uInt8 opcode, Reg dst, Reg src)
+{
+  emitRex(false, dst, src, true);
+  emit8(0x0F);
+  emit8(opcode);
+  emit8(0xC0 | ((dst & 7) << 3) | (src & 7));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::setCond(Cond cc, Reg reg)
+{
+  emitRex(false, 0, reg, true);
+  emit8(0x0F);
+  emit8(0x90 | cc);
+  emit8(0xC0 | (reg & 7));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* ThumbDynarec::jumpCond(Cond cc)
+{
+  emit8(0x0F);
+  emit8(0x80 | cc);
+  emit32(0);
+
+  return myPos - 4;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* ThumbDynarec::jump()
+{
+  emit8(0xE9);
+  emit32(0);
+
+  return myPos - 4;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::patchJump(uInt8* jump)
+{
+  const uInt32 rel = uInt32(myPos - (jump + 4));
+
+  jump[0] = rel & 0xFF;  jump[1] = (rel >> 8) & 0xFF;
+  jump[2] = (rel >> 16) & 0xFF;  jump[3] = rel >> 24;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::callFunction(const void* function, Reg arg2, Reg arg3)
+{
+  // The first argument is always the Thumbulator; the other arguments are
+  // moved last to first, since the registers may overlap
+#ifdef WIN64_ABI
+  if(arg3 != EAX) aluReg(MOV, R8, arg3);
+  if(arg2 != EAX) aluReg(MOV, EDX, arg2);
+  emit8(0x48);  emit8(0x89);  emit8(0xD9);  // mov rcx, rbx
+#else
+  if(arg3 != EAX) aluReg(MOV, EDX, arg3);
+  if(arg2 != EAX) aluReg(MOV, ESI, arg2);
+  emit8(0x48);  emit8(0x89);  emit8(0xDF);  // mov rdi, rbx
+#endif
+
+  // mov rax, function; call rax
+  const uInt64 target = reinterpret_cast<uInt64>(function);
+  emit8(0x48);
+  emit8(0xB8);
+  emit32(uInt32(target));
+  emit32(uInt32(target >> 32));
+  emit8(0xFF);
+  emit8(0xD0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::storeFlags(uInt32 mask, bool invertCarry)
+{
+  if(mask == 0)
+    return;
+
+  struct Flag { uInt32 flag; Cond cc; Reg reg; uInt8 bit; };
+  const std::array<Flag, 4> flags = {{
+    { CPSR_N, CC_S, R8, 31 },
+    { CPSR_Z, CC_Z, R9, 30 },
+    { CPSR_C, invertCarry ? CC_NC : CC_C, R10, 29 },
+    { CPSR_V, CC_O, R11, 28 }
+  }};
+
+  for(const auto& f: flags)
+    if(mask & f.flag)
+      setCond(f.cc, f.reg);
+
+  loadMem(ECX, myCpsrOffset);
+  aluImm(AND_I, ECX, ~mask);
+  for(const auto& f: flags)
+  {
+    if(mask & f.flag)
+    {
+      movExtend(MOVZX8, f.reg, f.reg);
+      shiftImm(SHL_I, f.reg, f.bit);
+      aluReg(OR, ECX, f.reg);
+    }
+  }
+  storeMem(myCpsrOffset, ECX);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::flushCounters()
+{
+  if(myPendingInstructions == 0)
+    return;
+
+  addMem64Imm(myInstructionsOffset, myPendingInstructions);
+#ifndef NO_THUMB_STATS
+  addMem64Imm(myFetchesOffset, myPendingInstructions);
+#endif
+  myPendingInstructions = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::checkException()
+{
+  // bt rax, 32; jc <exception>
+  emit8(0x48);  emit8(0x0F);  emit8(0xBA);  emit8(0xE0);  emit8(32);
+  myExceptionJumps.push_back(jumpCond(CC_C));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ThumbDynarec::offsetOf(const void* member) const
+{
+  return Int32(static_cast<const uInt8*>(member) -
+               reinterpret_cast<const uInt8*>(&myThumb));
+}
+
+#ifdef THUMB_DYNAREC_LOCKSTEP
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<uInt64> ThumbDynarec::saveState() const
+{
+  const Thumbulator& t = myThumb;
+  vector<uInt64> state(t.reg_norm.begin(), t.reg_norm.end());
+
+  state.insert(state.end(), {
+    t.cpsr, t.mamcr, t.handler_mode, t.systick_ctrl, t.systick_reload,
+    t.systick_count, t.systick_calibrate, t.T1TCR, t.T1TC,
+  #ifndef NO_THUMB_STATS
+    t.fetches, t.reads, t.writes,
+  #endif
+    t.instructions
+  });
+
+  return state;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbDynarec::loadState(const vector<uInt64>& state)
+{
+  Thumbulator& t = myThumb;
+  auto s = state.begin();
+
+  for(auto& reg: t.reg_norm)
+    reg = uInt32(*s++);
+  t.cpsr = uInt32(*s++);
+  t.mamcr = uInt32(*s++);
+  t.handler_mode = *s++;
+  t.systick_ctrl = uInt32(*s++);
+  t.systick_reload = uInt32(*s++);
+  t.systick_count = uInt32(*s++);
+  t.systick_calibrate = uInt32(*s++);
+  t.T1TCR = uInt32(*s++);
+  t.T1TC = uInt32(*s++);
+#ifndef NO_THUMB_STATS
+  t.fetches = *s++;
+  t.reads = *s++;
+  t.writes = *s++;
+#endif
+  t.instructions = *s;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int ThumbDynarec::verifyBlock(const Entry& entry, uInt32 addr)
+{
+  Thumbulator& t = myThumb;
+  vector<Thumbulator::RamWrite> translatedWrites, interpretedWrites;
+  const vector<uInt64> before = saveState();
+
+  // Run the translated code first...
+  t.ramWriteLog = &translatedWrites;
+  const Block block = reinterpret_cast<Block>(myCode + entry.offset);
+  const uInt32 translatedResult = block(&t);
+  t.ramWriteLog = nullptr;
+  myException = nullptr;
+  const vector<uInt64> translated = saveState();
+
+  // ... then undo everything, and let the interpreter run the same number
+  // of instructions
+  for(auto w = translatedWrites.rbegin(); w != translatedWrites.rend(); ++w)
+    t.ram[w->index] = w->before;
+  loadState(before);
+
+  const string where = "Thumb dynarec: block at " +
+    Common::Base::toString(addr, Common::Base::Fmt::_16_8) + " ";
+  const uInt64 count = translated.back() - before.back();
+  int result = 0;
+
+  t.ramWriteLog = &interpretedWrites;
+  try {
+    for(uInt64 i = 0; i < count && !result; ++i)
+      result = t.execute();
+  }
+  catch(...) {
+    t.ramWriteLog = nullptr;
+    if(translatedResult != BLOCK_EXCEPTION)
+      throw runtime_error(where + "did not throw an exception");
+    throw;
+  }
+  t.ramWriteLog = nullptr;
+
+  if(translatedResult == BLOCK_EXCEPTION)
+    throw runtime_error(where + "threw an exception");
+  if(uInt32(result) != translatedResult)
+    throw runtime_error(where + "returned a different result");
+  if(saveState() != translated)
+    throw runtime_error(where + "produced different registers or counters");
+
+  // The translated values of all addresses written by either of the two,
+  // or the original value if only the interpreter wrote them
+  std::map<uInt32, uInt16> ram;
+  for(const auto& w: translatedWrites)
+    ram[w.index] = w.after;
+  for(const auto& w: interpretedWrites)
+    ram.emplace(w.index, w.before);
+
+  for(const auto& [index, value]: ram)
+    if(t.ram[index] != value)
+      throw runtime_error(where + "wrote different RAM contents");
+
+  return result;
+}
+#endif
+
+#endif  // THUMB_DYNAREC
@@ -0,0 +1,234 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THUMB_DYNAREC_HXX
+#define THUMB_DYNAREC_HXX
+
+#include <exception>
+
+#include "bspf.hxx"
+#include "Thumbulator.hxx"
+
+#ifdef THUMB_DYNAREC
+
+/**
+  A dynamic recompiler for the Thumbulator, which translates frequently
+  executed blocks of Thumb code in the cartridge ROM into x86-64 code.
+
+  A block is a straight sequence of instructions, which ends with the first
+  instruction that may change the program flow.  Data processing, load/store
+  and B instructions are translated into native code; all other instructions
+  (e.g. BX, BL, PUSH/POP) call back into the interpreter.  Code running from
+  RAM is always interpreted, so self-modifying code is never translated.
+
+  The translated code updates the registers, the flags and all statistics
+  exactly like the interpreter does.  Building with THUMB_DYNAREC_LOCKSTEP
+  (see Thumbulator.hxx) verifies every executed block against the
+  interpreter.
+
+  @author  Stella Team
+*/
+class ThumbDynarec
+{
+  public:
+    explicit ThumbDynarec(Thumbulator& thumb);
+    ~ThumbDynarec();
+
+    /**
+      Answer whether executable memory for the translated code is available.
+    */
+    bool isValid() const { return myCode != nullptr; }
+
+    /**
+      Execute the translated block at the current pc, translating the block
+      first if it has become hot.
+
+      @param result  The result of the last instruction, as returned by
+                     Thumbulator::execute()
+      @return  True if a block was executed, false if the next instruction
+               must be interpreted
+    */
+    bool execute(int& result);
+
+  private:
+    using Block = uInt32 (*)(Thumbulator*);
+    using Op = Thumbulator::Op;
+
+    // A block entry point, per halfword of ROM
+    struct Entry {
+      uInt32 offset{0};  // offset of the translated code
+      uInt8 length{0};   // number of instructions in the block (0 = none)
+      uInt8 heat{0};     // number of executions before translation
+    };
+
+    // Registers of the x86-64
+    enum Reg: uInt8 {
+      EAX, ECX, EDX, EBX, ESP, EBP, ESI, EDI, R8, R9, R10, R11
+    };
+
+    // Condition codes of the x86-64
+    enum Cond: uInt8 {
+      CC_O = 0x0, CC_C = 0x2, CC_NC = 0x3, CC_Z = 0x4, CC_NZ = 0x5, CC_S = 0x8
+    };
+
+    // The result codes of a block
+    static constexpr uInt32 BLOCK_OK = 0, BLOCK_STOP = 1, BLOCK_EXCEPTION = 2;
+
+  private:
+    /**
+      Translate the block starting at the given ROM address.
+
+      @return  False if the block cannot be translated
+    */
+    bool translate(uInt32 addr, Entry& entry);
+
+    /**
+      Translate a single instruction at the given ROM address.
+
+      @return  False if the instruction must be interpreted
+    */
+    bool translateOp(const Thumbulator::DecodedOp& op, uInt32 addr);
+
+    /**
+      Answer whether the given instruction may change the program flow,
+      or stop the ARM code.
+    */
+    static bool endsBlock(const Thumbulator::DecodedOp& op);
+
+    /**
+      Run the given block, and return its result code.
+    */
+    uInt32 runBlock(const Entry& entry);
+
+#ifdef THUMB_DYNAREC_LOCKSTEP
+    /**
+      Run the given block, and then run the interpreter on the same
+      state, throwing a runtime_error on any difference.
+    */
+    int verifyBlock(const Entry& entry, uInt32 addr);
+
+    // Save and restore the registers and counters of the Thumbulator
+    vector<uInt64> saveState() const;
+    void loadState(const vector<uInt64>& state);
+#endif
+
+    // Functions called from the translated code.  The result is in the
+    // lower 32 bits, and the upper bits are set if an exception occurred.
+    static uInt64 interpret(Thumbulator* thumb);
+    static uInt64 load32(Thumbulator* thumb, uInt32 addr);
+    static uInt64 load16(Thumbulator* thumb, uInt32 addr);
+    static uInt64 load16s(Thumbulator* thumb, uInt32 addr);
+    static uInt64 load8(Thumbulator* thumb, uInt32 addr);
+    static uInt64 load8s(Thumbulator* thumb, uInt32 addr);
+    static uInt64 store32(Thumbulator* thumb, uInt32 addr, uInt32 data);
+    static uInt64 store16(Thumbulator* thumb, uInt32 addr, uInt32 data);
+    static uInt64 store8(Thumbulator* thumb, uInt32 addr, uInt32 data);
+
+    /**
+      Save the exception currently being handled, to rethrow it once the
+      translated code has been left.
+    */
+    static uInt64 saveException(Thumbulator* thumb);
+
+    // Code emitters; all memory operands are relative to the Thumbulator
+    // object, which is kept in RBX
+    void emit8(uInt8 b) { *myPos++ = b; }
+    void emit32(uInt32 d);
+    void emitRex(bool w, uInt8 reg, uInt8 rm, bool byteRegs = false);
+    void emitModRmMem(uInt8 reg, Int32 disp);
+    void loadReg(Reg reg, uInt32 armReg);
+    void storeReg(uInt32 armReg, Reg reg);
+    void loadMem(Reg reg, Int32 disp);
+    void storeMem(Int32 disp, Reg reg);
+    void storeMemImm(Int32 disp, uInt32 imm);
+    void addMem64Imm(Int32 disp, uInt32 imm);
+    void btMem(Int32 disp, uInt8 bit);
+    void movImm(Reg reg, uInt32 imm);
+    void aluReg(uInt8 opcode, Reg dst, Reg src);
+    void aluImm(uInt8 ext, Reg dst, uInt32 imm);
+    void shiftImm(uInt8 ext, Reg reg, uInt8 count);
+    void imul(Reg dst, Reg src);
+    void movExtend(uInt8 opcode, Reg dst, Reg src);
+    void setCond(Cond cc, Reg reg);
+    uInt8* jumpCond(Cond cc);
+    uInt8* jump();
+    void patchJump(uInt8* jump);
+    void callFunction(const void* function, Reg arg2 = EAX, Reg arg3 = EAX);
+
+    /**
+      Update the given CPSR flags from the x86-64 flags of the last
+      operation.  The carry flag is inverted for subtractions.
+    */
+    void storeFlags(uInt32 mask, bool invertCarry = false);
+
+    /**
+      Update the counters of the interpreter for the pending instructions.
+    */
+    void flushCounters();
+
+    /**
+      Leave the block (with the result code in EAX) if the last call
+      reported an exception.
+    */
+    void checkException();
+
+    /**
+      Offset of the given Thumbulator member, relative to RBX.
+    */
+    Int32 offsetOf(const void* member) const;
+
+  private:
+    Thumbulator& myThumb;
+
+    // The executable memory for the translated code
+    uInt8* myCode{nullptr};
+    uInt8* myPos{nullptr};
+    uInt8* myEnd{nullptr};
+
+    vector<Entry> myEntries;
+
+    // Jumps to the end of the block which is currently translated, and
+    // to its exception exit
+    vector<uInt8*> myExitJumps, myExceptionJumps;
+
+    // Address of the instruction which is currently translated
+    uInt32 myAddr{0};
+
+    // Instructions translated since the counters were last updated
+    uInt32 myPendingInstructions{0};
+
+    // Offsets of the registers, flags and counters of the Thumbulator
+    Int32 myRegOffset{0}, myCpsrOffset{0}, myInstructionsOffset{0};
+#ifndef NO_THUMB_STATS
+    Int32 myFetchesOffset{0}, myReadsOffset{0};
+#endif
+
+    // Exception thrown by the interpreter while running translated code
+    std::exception_ptr myException;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThumbDynarec() = delete;
+    ThumbDynarec(const ThumbDynarec&) = delete;
+    ThumbDynarec(ThumbDynarec&&) = delete;
+    ThumbDynarec& operator=(const ThumbDynarec&) = delete;
+    ThumbDynarec& operator=(ThumbDynarec&&) = delete;
+};
+
+#endif  // THUMB_DYNAREC
+
+#endif  // THUMB_DYNAREC_HXX
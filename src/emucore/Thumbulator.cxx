@@ -26,6 +26,7 @@
 #include "Base.hxx"
 #include "Cart.hxx"
 #include "Thumbulator.hxx"
+#include "ThumbDynarec.hxx"
 using Common::Base;
 
 // Uncomment the following to enable specific functionality
@@ -62,19 +63,25 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt32 rom_size
     cBase{c_base},
     cStart{c_start},
     cStack{c_stack},
-    decodedRom{make_unique<Op[]>(romSize / 2)},  // NOLINT
+    decodedRom{make_unique<DecodedOp[]>(romSize / 2)},  // NOLINT
     ram{ram_ptr},
     configuration{configurefor},
     myCartridge{cartridge}
 {
   for(uInt32 i = 0; i < romSize / 2; ++i)
-    decodedRom[i] = decodeInstructionWord(CONV_RAMROM(rom[i]));
+    decodedRom[i] = decodeInstruction(CONV_RAMROM(rom[i]));
 
   setConsoleTiming(ConsoleTiming::ntsc);
 #ifndef UNSAFE_OPTIMIZATIONS
   trapFatalErrors(traponfatal);
 #endif
   reset();
+
+#if defined(THUMB_DYNAREC) && !defined(THUMB_DISS) && !defined(THUMB_DBUG)
+  myDynarec = make_unique<ThumbDynarec>(*this);
+  if(!myDynarec->isValid())
+    myDynarec.reset();
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -83,6 +90,14 @@ string Thumbulator::run()
   reset();
   for(;;)
   {
+#ifdef THUMB_DYNAREC
+    int result = 0;
+    if(myDynarec && myDynarec->execute(result))
+    {
+      if(result) break;
+      continue;
+    }
+#endif
     if(execute()) break;
 #ifndef UNSAFE_OPTIMIZATIONS
     if(instructions > 500000) // way more than would otherwise be possible
@@ -101,26 +116,43 @@ string Thumbulator::run()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::setConsoleTiming(ConsoleTiming timing)
 {
-  // this sets how many ticks of the Harmony/Melody clock
+  // this sets how many ticks of the Harmony/Melody clock (70 MHz)
   // will occur per tick of the 6507 clock
-  constexpr double NTSC   = 70.0 / 1.193182;  // NTSC  6507 clock rate
-  constexpr double PAL    = 70.0 / 1.182298;  // PAL   6507 clock rate
-  constexpr double SECAM  = 70.0 / 1.187500;  // SECAM 6507 clock rate
+  constexpr uInt64 ARM    = 70000000;
+  constexpr uInt64 NTSC   = 1193182;  // NTSC  6507 clock rate
+  constexpr uInt64 PAL    = 1182298;  // PAL   6507 clock rate
+  constexpr uInt64 SECAM  = 1187500;  // SECAM 6507 clock rate
 
   switch(timing)
   {
-    case ConsoleTiming::ntsc:   timing_factor = NTSC;   break;
-    case ConsoleTiming::secam:  timing_factor = SECAM;  break;
-    case ConsoleTiming::pal:    timing_factor = PAL;    break;
+    case ConsoleTiming::ntsc:   myTimerClocks.setRates(ARM, NTSC);   break;
+    case ConsoleTiming::secam:  myTimerClocks.setRates(ARM, SECAM);  break;
+    case ConsoleTiming::pal:    myTimerClocks.setRates(ARM, PAL);    break;
     default:  break;  // satisfy compiler
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::save(Serializer& out) const
+{
+  out.putInt(T1TCR);
+  out.putInt(T1TC);
+  myTimerClocks.save(out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::load(Serializer& in)
+{
+  T1TCR = in.getInt();
+  T1TC = in.getInt();
+  myTimerClocks.load(in);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::updateTimer(uInt32 cycles)
 {
   if (T1TCR & 1) // bit 0 controls timer on/off
-    T1TC += uInt32(cycles * timing_factor);
+    T1TC += myTimerClocks.convert(cycles);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -240,6 +272,9 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
     case 0x40000000: //RAM
       addr &= RAMADDMASK;
       addr >>= 1;
+#ifdef THUMB_DYNAREC_LOCKSTEP
+      if(ramWriteLog) ramWriteLog->push_back({addr, ram[addr], uInt16(CONV_DATA(data))});
+#endif
       ram[addr] = CONV_DATA(data);
       return;
 
@@ -350,9 +385,28 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
 
 #ifndef UNSAFE_OPTIMIZATIONS
     case 0x40000000: //RAM
+      // Fast path for writes which pass all the checks of write16()
+      if(addr <= 0x40007ffc && !isProtected(addr + 2))
 #else
     default:
+      if((addr & 0xF0000000) == 0x40000000)
+#endif
+      {
+      #ifndef NO_THUMB_STATS
+        writes += 2;
+      #endif
+        addr = (addr & RAMADDMASK) >> 1;
+#ifdef THUMB_DYNAREC_LOCKSTEP
+        if(ramWriteLog)
+        {
+          ramWriteLog->push_back({addr, ram[addr], uInt16(CONV_DATA(data))});
+          ramWriteLog->push_back({addr + 1, ram[addr + 1], uInt16(CONV_DATA(data >> 16))});
+        }
 #endif
+        ram[addr]     = CONV_DATA(data);
+        ram[addr + 1] = CONV_DATA(data >> 16);
+        return;
+      }
       write16(addr+0, (data >>  0) & 0xFFFF);
       write16(addr+2, (data >> 16) & 0xFFFF);
       return;
@@ -448,6 +502,22 @@ uInt32 Thumbulator::read32(uInt32 addr)
 #endif
 
   uInt32 data;
+
+  // Fast paths for ROM and RAM, which pass all the checks of read16()
+  if(addr <= 0x0007fffc || (addr >= 0x40000000 && addr <= 0x40007ffc))
+  {
+  #ifndef NO_THUMB_STATS
+    reads += 2;
+  #endif
+    const uInt16* mem = addr < 0x40000000 ? rom : ram;
+    const uInt32 index = (addr & ROMADDMASK) >> 1;
+
+    data = CONV_RAMROM(mem[index]);
+    data |= uInt32(CONV_RAMROM(mem[index + 1])) << 16;
+    DO_DBUG(statusMsg << "read32(" << Base::HEX8 << addr << ")=" << Base::HEX8 << data << endl);
+    return data;
+  }
+
   switch(addr & 0xF0000000)
   {
     case 0x00000000: //ROM
@@ -810,15 +880,162 @@ Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst) {
   return Op::invalid;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Thumbulator::DecodedOp Thumbulator::decodeInstruction(uInt16 inst)
+{
+  DecodedOp d;
+  d.op = decodeInstructionWord(inst);
+  d.inst = inst;
+
+  const uInt8 r0 = inst & 0x7, r3 = (inst >> 3) & 0x7,
+              r6 = (inst >> 6) & 0x7, r8 = (inst >> 8) & 0x7;
+  const uInt8 imm5 = (inst >> 6) & 0x1F;
+
+  switch(d.op)
+  {
+    // Two low registers
+    case Op::adc:   case Op::and_:  case Op::asr2:  case Op::bic:
+    case Op::cpy:   case Op::eor:   case Op::lsl2:  case Op::lsr2:
+    case Op::mul:   case Op::mvn:   case Op::neg:   case Op::orr:
+    case Op::ror:   case Op::sbc:   case Op::sxtb:  case Op::sxth:
+    case Op::uxtb:  case Op::uxth:
+      d.rd = r0;  d.rm = r3;
+      break;
+
+    case Op::cmn:   case Op::cmp2:  case Op::tst:
+      d.rn = r0;  d.rm = r3;
+      break;
+
+    case Op::mov2:  case Op::rev:   case Op::rev16: case Op::revsh:
+      d.rd = r0;  d.rn = r3;
+      break;
+
+    // Three low registers
+    case Op::add3:  case Op::ldr2:  case Op::ldrb2: case Op::ldrh2:
+    case Op::ldrsb: case Op::ldrsh: case Op::str2:  case Op::strb2:
+    case Op::strh2: case Op::sub3:
+      d.rd = r0;  d.rn = r3;  d.rm = r6;
+      break;
+
+    // Two low registers and an immediate
+    case Op::add1:  case Op::sub1:
+      d.rd = r0;  d.rn = r3;  d.imm = r6;
+      break;
+
+    case Op::asr1:  case Op::lsl1:  case Op::lsr1:
+      d.rd = r0;  d.rm = r3;  d.imm = imm5;
+      break;
+
+    case Op::ldr1:  case Op::str1:
+      d.rd = r0;  d.rn = r3;  d.imm = imm5 << 2;
+      break;
+
+    case Op::ldrh1: case Op::strh1:
+      d.rd = r0;  d.rn = r3;  d.imm = imm5 << 1;
+      break;
+
+    case Op::ldrb1: case Op::strb1:
+      d.rd = r0;  d.rn = r3;  d.imm = imm5;
+      break;
+
+    // One low register and an 8 bit immediate
+    case Op::add2:  case Op::mov1:  case Op::sub2:
+      d.rd = r8;  d.imm = inst & 0xFF;
+      break;
+
+    case Op::add5:  case Op::add6:  case Op::ldr3:  case Op::ldr4:
+    case Op::str3:
+      d.rd = r8;  d.imm = (inst & 0xFF) << 2;
+      break;
+
+    case Op::cmp1:
+      d.rn = r8;  d.imm = inst & 0xFF;
+      break;
+
+    case Op::add7:  case Op::sub4:
+      d.imm = (inst & 0x7F) << 2;
+      break;
+
+    // High registers
+    case Op::add4:  case Op::mov3:
+      d.rd = r0 | ((inst >> 4) & 0x8);  d.rm = (inst >> 3) & 0xF;
+      break;
+
+    case Op::cmp3:
+      d.rn = r0 | ((inst >> 4) & 0x8);  d.rm = (inst >> 3) & 0xF;
+      break;
+
+    case Op::blx2:  case Op::bx:
+      d.rm = (inst >> 3) & 0xF;
+      break;
+
+    // Branches; the offset includes the pipelining of the pc, and the
+    // condition of B(1) is kept in 'rd'
+    case Op::b1:
+      d.rd = (inst >> 8) & 0xF;
+      d.imm = Int16((Int8(inst & 0xFF) << 1) + 2);
+      break;
+
+    case Op::b2:
+      d.imm = Int16((((inst & 0x7FF) ^ 0x400) - 0x400) * 2 + 2);
+      break;
+
+    // Register lists
+    case Op::ldmia: case Op::stmia:
+      d.rn = r8;  d.imm = inst & 0xFF;
+      break;
+
+    case Op::pop:   case Op::push:
+      d.imm = inst & 0x1FF;
+      break;
+
+    case Op::bkpt:  case Op::swi:
+      d.imm = inst & 0xFF;
+      break;
+
+    default:  // remaining ones use the instruction word
+      break;
+  }
+
+  return d;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Thumbulator::execute()
 {
-  uInt32 pc, sp, inst, ra, rb, rc, rm, rd, rn, rs, op;
+  uInt32 pc, sp, inst, ra, rb, rc, rm, rd, rn, rs;
 
   pc = read_register(15);
 
   uInt32 instructionPtr = pc - 2;
-  inst = fetch16(instructionPtr);
+
+  // Instructions in ROM come from the decode cache; everything else (i.e.
+  // code running from RAM) is decoded on the fly
+#ifndef UNSAFE_OPTIMIZATIONS
+  DecodedOp decoded;
+  const DecodedOp* op;
+  if((instructionPtr & 0xF0000000) == 0 && instructionPtr < romSize)
+  {
+  #ifndef NO_THUMB_STATS
+    ++fetches;
+  #endif
+    if(instructionPtr < 0x50)
+      fatalError("fetch16", instructionPtr, "abort");
+    op = &decodedRom[instructionPtr >> 1];
+  }
+  else
+  {
+    decoded = decodeInstruction(fetch16(instructionPtr));
+    op = &decoded;
+  }
+#else
+  #ifndef NO_THUMB_STATS
+  ++fetches;
+  #endif
+  const DecodedOp* op = &decodedRom[(instructionPtr & ROMADDMASK) >> 1];
+#endif
+  const DecodedOp& d = *op;
+  inst = d.inst;
 
   pc += 2;
   write_register(15, pc);
@@ -828,21 +1045,11 @@ int Thumbulator::execute()
   ++instructions;
 #endif
 
-  Op decodedOp;
-#ifndef UNSAFE_OPTIMIZATIONS
-  if ((instructionPtr & 0xF0000000) == 0 && instructionPtr < romSize)
-    decodedOp = decodedRom[instructionPtr >> 1];
-  else
-    decodedOp = decodeInstructionWord(inst);
-#else
-  decodedOp = decodedRom[(instructionPtr & ROMADDMASK) >> 1];
-#endif
-
-  switch (decodedOp) {
+  switch (d.op) {
     //ADC
     case Op::adc: {
-      rd = (inst >> 0) & 0x07;
-      rm = (inst >> 3) & 0x07;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "adc r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -859,9 +1066,9 @@ int Thumbulator::execute()
 
     //ADD(1) small immediate two registers
     case Op::add1: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rb = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       if(rb)
       {
         DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ","
@@ -886,8 +1093,8 @@ int Thumbulator::execute()
 
     //ADD(2) big immediate one register
     case Op::add2: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x7;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "adds r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
       ra = read_register(rd);
       rc = ra + rb;
@@ -901,9 +1108,9 @@ int Thumbulator::execute()
 
     //ADD(3) three registers
     case Op::add3: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ",r" << rm << endl);
       ra = read_register(rn);
       rb = read_register(rm);
@@ -922,9 +1129,8 @@ int Thumbulator::execute()
       {
         //UNPREDICTABLE
       }
-      rd  = (inst >> 0) & 0x7;
-      rd |= (inst >> 4) & 0x8;
-      rm  = (inst >> 3) & 0xF;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "add r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -945,9 +1151,8 @@ int Thumbulator::execute()
 
     //ADD(5) rd = pc plus immediate
     case Op::add5: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x7;
-      rb <<= 2;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "add r" << dec << rd << ",PC,#0x" << Base::HEX2 << rb << endl);
       ra = read_register(15);
       rc = (ra & (~3U)) + rb;
@@ -957,9 +1162,8 @@ int Thumbulator::execute()
 
     //ADD(6) rd = sp plus immediate
     case Op::add6: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x7;
-      rb <<= 2;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "add r" << dec << rd << ",SP,#0x" << Base::HEX2 << rb << endl);
       ra = read_register(13);
       rc = ra + rb;
@@ -969,8 +1173,7 @@ int Thumbulator::execute()
 
     //ADD(7) sp plus immediate
     case Op::add7: {
-      rb = (inst >> 0) & 0x7F;
-      rb <<= 2;
+      rb = d.imm;
       DO_DISS(statusMsg << "add SP,#0x" << Base::HEX2 << rb << endl);
       ra = read_register(13);
       rc = ra + rb;
@@ -980,8 +1183,8 @@ int Thumbulator::execute()
 
     //AND
     case Op::and_: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "ands r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -994,9 +1197,9 @@ int Thumbulator::execute()
 
     //ASR(1) two register immediate
     case Op::asr1: {
-      rd = (inst >> 0) & 0x07;
-      rm = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
+      rd = d.rd;
+      rm = d.rm;
+      rb = d.imm;
       DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
       rc = read_register(rm);
       if(rb == 0)
@@ -1028,8 +1231,8 @@ int Thumbulator::execute()
 
     //ASR(2) two register
     case Op::asr2: {
-      rd = (inst >> 0) & 0x07;
-      rs = (inst >> 3) & 0x07;
+      rd = d.rd;
+      rs = d.rm;
       DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rs << endl);
       rc = read_register(rd);
       rb = read_register(rs);
@@ -1068,14 +1271,8 @@ int Thumbulator::execute()
 
     //B(1) conditional branch
     case Op::b1: {
-      rb = (inst >> 0) & 0xFF;
-      if(rb & 0x80)
-        rb |= (~0U) << 8;
-      op=(inst >> 8) & 0xF;
-      rb <<= 1;
-      rb += pc;
-      rb += 2;
-      switch(op)
+      rb = pc + d.imm;
+      switch(d.rd)
       {
         case 0x0: //b eq  z set
           DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
@@ -1185,12 +1382,7 @@ int Thumbulator::execute()
 
     //B(2) unconditional branch
     case Op::b2: {
-      rb = (inst >> 0) & 0x7FF;
-      if(rb & (1 << 10))
-        rb |= (~0U) << 11;
-      rb <<= 1;
-      rb += pc;
-      rb += 2;
+      rb = pc + d.imm;
       DO_DISS(statusMsg << "B 0x" << Base::HEX8 << (rb-3) << endl);
       write_register(15, rb);
       return 0;
@@ -1198,8 +1390,8 @@ int Thumbulator::execute()
 
     //BIC
     case Op::bic: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "bics r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -1213,7 +1405,7 @@ int Thumbulator::execute()
 #ifndef UNSAFE_OPTIMIZATIONS
     //BKPT
     case Op::bkpt: {
-      rb = (inst >> 0) & 0xFF;
+      rb = d.imm;
       statusMsg << "bkpt 0x" << Base::HEX2 << rb << endl;
       return 1;
     }
@@ -1261,7 +1453,7 @@ int Thumbulator::execute()
 
     //BLX(2)
     case Op::blx2: {
-      rm = (inst >> 3) & 0xF;
+      rm = d.rm;
       DO_DISS(statusMsg << "blx r" << dec << rm << endl);
       rc = read_register(rm);
       //fprintf(stderr,"blx r%u 0x%X 0x%X\n",rm,rc,pc);
@@ -1283,7 +1475,7 @@ int Thumbulator::execute()
 
     //BX
     case Op::bx: {
-      rm = (inst >> 3) & 0xF;
+      rm = d.rm;
       DO_DISS(statusMsg << "bx r" << dec << rm << endl);
       rc = read_register(rm);
       rc += 2;
@@ -1510,8 +1702,8 @@ int Thumbulator::execute()
 
     //CMN
     case Op::cmn: {
-      rn = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "cmns r" << dec << rn << ",r" << dec << rm << endl);
       ra = read_register(rn);
       rb = read_register(rm);
@@ -1525,8 +1717,8 @@ int Thumbulator::execute()
 
     //CMP(1) compare immediate
     case Op::cmp1: {
-      rb = (inst >> 0) & 0xFF;
-      rn = (inst >> 8) & 0x07;
+      rb = d.imm;
+      rn = d.rn;
       DO_DISS(statusMsg << "cmp r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
       ra = read_register(rn);
       rc = ra - rb;
@@ -1540,8 +1732,8 @@ int Thumbulator::execute()
 
     //CMP(2) compare register
     case Op::cmp2: {
-      rn = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
       ra = read_register(rn);
       rb = read_register(rm);
@@ -1560,13 +1752,12 @@ int Thumbulator::execute()
       {
         //UNPREDICTABLE
       }
-      rn = (inst >> 0) & 0x7;
-      rn |= (inst >> 4) & 0x8;
+      rn = d.rn;
       if(rn == 0xF)
       {
         //UNPREDICTABLE
       }
-      rm = (inst >> 3) & 0xF;
+      rm = d.rm;
       DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
       ra = read_register(rn);
       rb = read_register(rm);
@@ -1590,8 +1781,8 @@ int Thumbulator::execute()
     case Op::cpy: {
       //same as mov except you can use both low registers
       //going to let mov handle high registers
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "cpy r" << dec << rd << ",r" << dec << rm << endl);
       rc = read_register(rm);
       write_register(rd, rc);
@@ -1600,8 +1791,8 @@ int Thumbulator::execute()
 
     //EOR
     case Op::eor: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "eors r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -1614,12 +1805,12 @@ int Thumbulator::execute()
 
     //LDMIA
     case Op::ldmia: {
-      rn = (inst >> 8) & 0x7;
+      rn = d.rn;
     #if defined(THUMB_DISS)
       statusMsg << "ldmia r" << dec << rn << "!,{";
       for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,++ra)
       {
-        if(inst&rb)
+        if(d.imm & rb)
         {
           if(rc) statusMsg << ",";
           statusMsg << "r" << dec << ra;
@@ -1631,14 +1822,14 @@ int Thumbulator::execute()
       sp = read_register(rn);
       for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ++ra)
       {
-        if(inst & rb)
+        if(d.imm & rb)
         {
           write_register(ra, read32(sp));
           sp += 4;
         }
       }
       //there is a write back exception.
-      if((inst & (1 << rn)) == 0)
+      if((d.imm & (1 << rn)) == 0)
         write_register(rn, sp);
 
       return 0;
@@ -1646,10 +1837,9 @@ int Thumbulator::execute()
 
     //LDR(1) two register immediate
     case Op::ldr1: {
-      rd = (inst >> 0) & 0x07;
-      rn = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
-      rb <<= 2;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc = read32(rb);
@@ -1659,9 +1849,9 @@ int Thumbulator::execute()
 
     //LDR(2) three register
     case Op::ldr2: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",r" << dec << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read32(rb);
@@ -1671,9 +1861,8 @@ int Thumbulator::execute()
 
     //LDR(3)
     case Op::ldr3: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x07;
-      rb <<= 2;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "ldr r" << dec << rd << ",[PC+#0x" << Base::HEX2 << rb << "] ");
       ra = read_register(15);
       ra &= ~3;
@@ -1686,9 +1875,8 @@ int Thumbulator::execute()
 
     //LDR(4)
     case Op::ldr4: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x07;
-      rb <<= 2;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "ldr r" << dec << rd << ",[SP+#0x" << Base::HEX2 << rb << "]" << endl);
       ra = read_register(13);
       //ra&=~3;
@@ -1700,9 +1888,9 @@ int Thumbulator::execute()
 
     //LDRB(1)
     case Op::ldrb1: {
-      rd = (inst >> 0) & 0x07;
-      rn = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -1723,9 +1911,9 @@ int Thumbulator::execute()
 
     //LDRB(2)
     case Op::ldrb2: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -1743,10 +1931,9 @@ int Thumbulator::execute()
 
     //LDRH(1)
     case Op::ldrh1: {
-      rd = (inst >> 0) & 0x07;
-      rn = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
-      rb <<= 1;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc = read16(rb);
@@ -1756,9 +1943,9 @@ int Thumbulator::execute()
 
     //LDRH(2)
     case Op::ldrh2: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read16(rb);
@@ -1768,9 +1955,9 @@ int Thumbulator::execute()
 
     //LDRSB
     case Op::ldrsb: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "ldrsb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -1791,9 +1978,9 @@ int Thumbulator::execute()
 
     //LDRSH
     case Op::ldrsh: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "ldrsh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read16(rb);
@@ -1806,9 +1993,9 @@ int Thumbulator::execute()
 
     //LSL(1)
     case Op::lsl1: {
-      rd = (inst >> 0) & 0x07;
-      rm = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
+      rd = d.rd;
+      rm = d.rm;
+      rb = d.imm;
       DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
       rc = read_register(rm);
       if(rb == 0)
@@ -1831,8 +2018,8 @@ int Thumbulator::execute()
 
     //LSL(2) two register
     case Op::lsl2: {
-      rd = (inst >> 0) & 0x07;
-      rs = (inst >> 3) & 0x07;
+      rd = d.rd;
+      rs = d.rm;
       DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rs << endl);
       rc = read_register(rd);
       rb = read_register(rs);
@@ -1863,9 +2050,9 @@ int Thumbulator::execute()
 
     //LSR(1) two register immediate
     case Op::lsr1: {
-      rd = (inst >> 0) & 0x07;
-      rm = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
+      rd = d.rd;
+      rm = d.rm;
+      rb = d.imm;
       DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
       rc = read_register(rm);
       if(rb == 0)
@@ -1886,8 +2073,8 @@ int Thumbulator::execute()
 
     //LSR(2) two register
     case Op::lsr2: {
-      rd = (inst >> 0) & 0x07;
-      rs = (inst >> 3) & 0x07;
+      rd = d.rd;
+      rs = d.rm;
       DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rs << endl);
       rc = read_register(rd);
       rb = read_register(rs);
@@ -1918,8 +2105,8 @@ int Thumbulator::execute()
 
     //MOV(1) immediate
     case Op::mov1: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x07;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "movs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
       write_register(rd, rb);
       do_nflag(rb);
@@ -1929,8 +2116,8 @@ int Thumbulator::execute()
 
     //MOV(2) two low registers
     case Op::mov2: {
-      rd = (inst >> 0) & 7;
-      rn = (inst >> 3) & 7;
+      rd = d.rd;
+      rn = d.rn;
       DO_DISS(statusMsg << "movs r" << dec << rd << ",r" << dec << rn << endl);
       rc = read_register(rn);
       //fprintf(stderr,"0x%08X\n",rc);
@@ -1944,9 +2131,8 @@ int Thumbulator::execute()
 
     //MOV(3)
     case Op::mov3: {
-      rd  = (inst >> 0) & 0x7;
-      rd |= (inst >> 4) & 0x8;
-      rm  = (inst >> 3) & 0xF;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "mov r" << dec << rd << ",r" << dec << rm << endl);
       rc = read_register(rm);
       if((rd == 14) && (rm == 15))
@@ -1965,8 +2151,8 @@ int Thumbulator::execute()
 
     //MUL
     case Op::mul: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "muls r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -1979,8 +2165,8 @@ int Thumbulator::execute()
 
     //MVN
     case Op::mvn: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "mvns r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = (~ra);
@@ -1992,8 +2178,8 @@ int Thumbulator::execute()
 
     //NEG
     case Op::neg: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "negs r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = 0 - ra;
@@ -2007,8 +2193,8 @@ int Thumbulator::execute()
 
     //ORR
     case Op::orr: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "orrs r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -2025,14 +2211,14 @@ int Thumbulator::execute()
       statusMsg << "pop {";
       for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,++ra)
       {
-        if(inst&rb)
+        if(d.imm & rb)
         {
           if(rc) statusMsg << ",";
           statusMsg << "r" << dec << ra;
           rc++;
         }
       }
-      if(inst&0x100)
+      if(d.imm & 0x100)
       {
         if(rc) statusMsg << ",";
         statusMsg << "pc";
@@ -2043,13 +2229,13 @@ int Thumbulator::execute()
       sp = read_register(13);
       for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ++ra)
       {
-        if(inst & rb)
+        if(d.imm & rb)
         {
           write_register(ra, read32(sp));
           sp += 4;
         }
       }
-      if(inst & 0x100)
+      if(d.imm & 0x100)
       {
         rc = read32(sp);
         rc += 2;
@@ -2066,14 +2252,14 @@ int Thumbulator::execute()
       statusMsg << "push {";
       for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,++ra)
       {
-        if(inst&rb)
+        if(d.imm & rb)
         {
           if(rc) statusMsg << ",";
           statusMsg << "r" << dec << ra;
           rc++;
         }
       }
-      if(inst&0x100)
+      if(d.imm & 0x100)
       {
         if(rc) statusMsg << ",";
         statusMsg << "lr";
@@ -2085,24 +2271,24 @@ int Thumbulator::execute()
       //fprintf(stderr,"sp 0x%08X\n",sp);
       for(ra = 0, rb = 0x01, rc = 0; rb; rb = (rb << 1) & 0xFF, ++ra)
       {
-        if(inst & rb)
+        if(d.imm & rb)
         {
           ++rc;
         }
       }
-      if(inst & 0x100) ++rc;
+      if(d.imm & 0x100) ++rc;
       rc <<= 2;
       sp -= rc;
       rd = sp;
       for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ++ra)
       {
-        if(inst & rb)
+        if(d.imm & rb)
         {
           write32(rd, read_register(ra));
           rd += 4;
         }
       }
-      if(inst & 0x100)
+      if(d.imm & 0x100)
       {
         rc = read_register(14);
         write32(rd, rc);
@@ -2117,8 +2303,8 @@ int Thumbulator::execute()
 
     //REV
     case Op::rev: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
       DO_DISS(statusMsg << "rev r" << dec << rd << ",r" << dec << rn << endl);
       ra = read_register(rn);
       rc  = ((ra >>  0) & 0xFF) << 24;
@@ -2131,8 +2317,8 @@ int Thumbulator::execute()
 
     //REV16
     case Op::rev16: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
       DO_DISS(statusMsg << "rev16 r" << dec << rd << ",r" << dec << rn << endl);
       ra = read_register(rn);
       rc  = ((ra >>  0) & 0xFF) <<  8;
@@ -2145,8 +2331,8 @@ int Thumbulator::execute()
 
     //REVSH
     case Op::revsh: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
       DO_DISS(statusMsg << "revsh r" << dec << rd << ",r" << dec << rn << endl);
       ra = read_register(rn);
       rc  = ((ra >> 0) & 0xFF) << 8;
@@ -2159,8 +2345,8 @@ int Thumbulator::execute()
 
     //ROR
     case Op::ror: {
-      rd = (inst >> 0) & 0x7;
-      rs = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rs = d.rm;
       DO_DISS(statusMsg << "rors r" << dec << rd << ",r" << dec << rs << endl);
       rc = read_register(rd);
       ra = read_register(rs);
@@ -2191,8 +2377,8 @@ int Thumbulator::execute()
 
     //SBC
     case Op::sbc: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "sbc r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rd);
       rb = read_register(rm);
@@ -2224,12 +2410,12 @@ int Thumbulator::execute()
 
     //STMIA
     case Op::stmia: {
-      rn = (inst >> 8) & 0x7;
+      rn = d.rn;
     #if defined(THUMB_DISS)
       statusMsg << "stmia r" << dec << rn << "!,{";
       for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,++ra)
       {
-        if(inst & rb)
+        if(d.imm & rb)
         {
           if(rc) statusMsg << ",";
           statusMsg << "r" << dec << ra;
@@ -2242,7 +2428,7 @@ int Thumbulator::execute()
       sp = read_register(rn);
       for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ++ra)
       {
-        if(inst & rb)
+        if(d.imm & rb)
         {
           write32(sp, read_register(ra));
           sp += 4;
@@ -2254,10 +2440,9 @@ int Thumbulator::execute()
 
     //STR(1)
     case Op::str1: {
-      rd = (inst >> 0) & 0x07;
-      rn = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
-      rb <<= 2;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc = read_register(rd);
@@ -2267,9 +2452,9 @@ int Thumbulator::execute()
 
     //STR(2)
     case Op::str2: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read_register(rd);
@@ -2279,9 +2464,8 @@ int Thumbulator::execute()
 
     //STR(3)
     case Op::str3: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x07;
-      rb <<= 2;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "str r" << dec << rd << ",[SP,#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(13) + rb;
       //fprintf(stderr,"0x%08X\n",rb);
@@ -2292,9 +2476,9 @@ int Thumbulator::execute()
 
     //STRB(1)
     case Op::strb1: {
-      rd = (inst >> 0) & 0x07;
-      rn = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX8 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc = read_register(rd);
@@ -2319,9 +2503,9 @@ int Thumbulator::execute()
 
     //STRB(2)
     case Op::strb2: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",r" << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read_register(rd);
@@ -2346,10 +2530,9 @@ int Thumbulator::execute()
 
     //STRH(1)
     case Op::strh1: {
-      rd = (inst >> 0) & 0x07;
-      rn = (inst >> 3) & 0x07;
-      rb = (inst >> 6) & 0x1F;
-      rb <<= 1;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc=  read_register(rd);
@@ -2359,9 +2542,9 @@ int Thumbulator::execute()
 
     //STRH(2)
     case Op::strh2: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read_register(rd);
@@ -2371,9 +2554,9 @@ int Thumbulator::execute()
 
     //SUB(1)
     case Op::sub1: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rb = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rb = d.imm;
       DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
       ra = read_register(rn);
       rc = ra - rb;
@@ -2387,8 +2570,8 @@ int Thumbulator::execute()
 
     //SUB(2)
     case Op::sub2: {
-      rb = (inst >> 0) & 0xFF;
-      rd = (inst >> 8) & 0x07;
+      rb = d.imm;
+      rd = d.rd;
       DO_DISS(statusMsg << "subs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
       ra = read_register(rd);
       rc = ra - rb;
@@ -2402,9 +2585,9 @@ int Thumbulator::execute()
 
     //SUB(3)
     case Op::sub3: {
-      rd = (inst >> 0) & 0x7;
-      rn = (inst >> 3) & 0x7;
-      rm = (inst >> 6) & 0x7;
+      rd = d.rd;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",r" << dec << rm << endl);
       ra = read_register(rn);
       rb = read_register(rm);
@@ -2419,8 +2602,7 @@ int Thumbulator::execute()
 
     //SUB(4)
     case Op::sub4: {
-      rb = inst & 0x7F;
-      rb <<= 2;
+      rb = d.imm;
       DO_DISS(statusMsg << "sub SP,#0x" << Base::HEX2 << rb << endl);
       ra = read_register(13);
       ra -= rb;
@@ -2430,7 +2612,7 @@ int Thumbulator::execute()
 
     //SWI
     case Op::swi: {
-      rb = inst & 0xFF;
+      rb = d.imm;
       DO_DISS(statusMsg << "swi 0x" << Base::HEX2 << rb << endl);
 
       if(rb == 0xCC)
@@ -2449,8 +2631,8 @@ int Thumbulator::execute()
 
     //SXTB
     case Op::sxtb: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "sxtb r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = ra & 0xFF;
@@ -2462,8 +2644,8 @@ int Thumbulator::execute()
 
     //SXTH
     case Op::sxth: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "sxth r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = ra & 0xFFFF;
@@ -2475,8 +2657,8 @@ int Thumbulator::execute()
 
     //TST
     case Op::tst: {
-      rn = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rn = d.rn;
+      rm = d.rm;
       DO_DISS(statusMsg << "tst r" << dec << rn << ",r" << dec << rm << endl);
       ra = read_register(rn);
       rb = read_register(rm);
@@ -2488,8 +2670,8 @@ int Thumbulator::execute()
 
     //UXTB
     case Op::uxtb: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "uxtb r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = ra & 0xFF;
@@ -2499,8 +2681,8 @@ int Thumbulator::execute()
 
     //UXTH
     case Op::uxth: {
-      rd = (inst >> 0) & 0x7;
-      rm = (inst >> 3) & 0x7;
+      rd = d.rd;
+      rm = d.rm;
       DO_DISS(statusMsg << "uxth r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = ra & 0xFFFF;
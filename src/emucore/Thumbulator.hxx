@@ -26,15 +26,29 @@
 #define THUMBULATOR_HXX
 
 class Cartridge;
+class ThumbDynarec;
 
 #include "bspf.hxx"
 #include "Console.hxx"
+#include "ClockConverter.hxx"
 
 #ifdef RETRON77
   #define UNSAFE_OPTIMIZATIONS
   #define NO_THUMB_STATS
 #endif
 
+// The dynamic recompiler (see ThumbDynarec) is enabled by building with
+// THUMB_DYNAREC_SUPPORT (configure --enable-thumb-dynarec), and is only
+// available on x86-64.  THUMB_DYNAREC_LOCKSTEP (configure
+// --enable-thumb-lockstep) verifies all translated code against the
+// interpreter.
+#if defined(THUMB_DYNAREC_SUPPORT) && (defined(__x86_64__) || defined(_M_X64)) && \
+    !defined(UNSAFE_OPTIMIZATIONS)
+  #define THUMB_DYNAREC
+#else
+  #undef THUMB_DYNAREC_LOCKSTEP
+#endif
+
 #define ROMADDMASK 0x7FFFF
 #define RAMADDMASK 0x7FFF
 
@@ -64,6 +78,7 @@ class Thumbulator
                 const uInt32 c_base, const uInt32 c_start, const uInt32 c_stack,
                 bool traponfatal, Thumbulator::ConfigureFor configurefor,
                 Cartridge* cartridge);
+    ~Thumbulator() = default;
 
     /**
       Run the ARM code, and return when finished.  A runtime_error exception is
@@ -99,6 +114,13 @@ class Thumbulator
     */
     void setConsoleTiming(ConsoleTiming timing);
 
+    /**
+      Save/load the state of the timer, including the fraction of a timer
+      tick left over, to/from the given Serializer.
+    */
+    void save(Serializer& out) const;
+    void load(Serializer& in);
+
   private:
 
     enum class Op : uInt8 {
@@ -151,6 +173,18 @@ class Thumbulator
       uxth
     };
 
+    /**
+      A fully decoded instruction.  Which of the register fields are used
+      depends on the opcode; 'imm' holds the (already scaled) immediate,
+      the branch offset relative to the pc, or the register list.
+    */
+    struct DecodedOp {
+      Int16 imm{0};
+      uInt16 inst{0};
+      Op op{Op::invalid};
+      uInt8 rd{0}, rn{0}, rm{0};
+    };
+
   private:
     uInt32 read_register(uInt32 reg);
     void write_register(uInt32 reg, uInt32 data);
@@ -165,6 +199,7 @@ class Thumbulator
     void updateTimer(uInt32 cycles);
 
     static Op decodeInstructionWord(uint16_t inst);
+    static DecodedOp decodeInstruction(uInt16 inst);
 
     void do_zflag(uInt32 x);
     void do_nflag(uInt32 x);
@@ -192,7 +227,7 @@ class Thumbulator
     uInt32 cBase{0};
     uInt32 cStart{0};
     uInt32 cStack{0};
-    const unique_ptr<Op[]> decodedRom;  // NOLINT
+    const unique_ptr<DecodedOp[]> decodedRom;  // NOLINT
     uInt16* ram{nullptr};
     std::array<uInt32, 16> reg_norm; // normal execution mode, do not have a thread mode
     uInt32 cpsr{0}, mamcr{0};
@@ -210,7 +245,7 @@ class Thumbulator
     // http://www.nxp.com/documents/user_manual/UM10161.pdf
     uInt32 T1TCR{0};  // Timer 1 Timer Control Register
     uInt32 T1TC{0};   // Timer 1 Timer Counter
-    double timing_factor{0.0};
+    ClockConverter myTimerClocks;  // converts 6507 cycles into timer ticks
 
 #ifndef UNSAFE_OPTIMIZATIONS
     ostringstream statusMsg;
@@ -222,6 +257,20 @@ class Thumbulator
 
     Cartridge* myCartridge;
 
+#ifdef THUMB_DYNAREC
+    unique_ptr<ThumbDynarec> myDynarec;
+
+    friend class ThumbDynarec;
+#endif
+#ifdef THUMB_DYNAREC_LOCKSTEP
+    // While translated code is verified, all writes to RAM are logged
+    struct RamWrite {
+      uInt32 index;
+      uInt16 before, after;
+    };
+    vector<RamWrite>* ramWriteLog{nullptr};
+#endif
+
   private:
     // Following constructors and assignment operators not supported
     Thumbulator() = delete;
@@ -231,4 +280,9 @@ class Thumbulator
     Thumbulator& operator=(Thumbulator&&) = delete;
 };
 
+// The (default) destructor needs the complete recompiler class
+#ifdef THUMB_DYNAREC
+  #include "ThumbDynarec.hxx"
+#endif
+
 #endif  // THUMBULATOR_HXX
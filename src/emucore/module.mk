@@ -3,6 +3,7 @@ MODULE := src/emucore
 MODULE_OBJS := \
         src/emucore/AtariVox.o \
         src/emucore/Bankswitch.o \
+        src/emucore/BatchRunner.o \
         src/emucore/Booster.o \
         src/emucore/Cart.o \
         src/emucore/CartCreator.o \
@@ -74,6 +75,7 @@ MODULE_OBJS := \
         src/emucore/M6532.o \
         src/emucore/MT24LC256.o \
         src/emucore/MD5.o \
+        src/emucore/MD5Cache.o \
         src/emucore/OSystem.o \
         src/emucore/Paddles.o \
         src/emucore/PlusROM.o \
@@ -88,7 +90,8 @@ MODULE_OBJS := \
         src/emucore/Switches.o \
         src/emucore/System.o \
         src/emucore/TIASurface.o \
-        src/emucore/Thumbulator.o
+        src/emucore/Thumbulator.o \
+        src/emucore/ThumbDynarec.o
 
 MODULE_DIRS += \
         src/emucore
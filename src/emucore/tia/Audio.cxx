@@ -80,6 +80,13 @@ void Audio::tick()
   if (++myCounter == 228) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::tick(uInt32 clocks)
+{
+  for (uInt32 i = 0; i < clocks; ++i)
+    tick();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::phase1()
 {
@@ -35,6 +35,11 @@ class Audio : public Serializable
 
     void tick();
 
+    /**
+      Advance by the given number of clocks at once.
+    */
+    void tick(uInt32 clocks);
+
     AudioChannel& channel0();
 
     AudioChannel& channel1();
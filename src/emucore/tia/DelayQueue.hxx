@@ -43,11 +43,24 @@ class DelayQueue : public Serializable
 
     template<typename T> void execute(T executor);
 
+    /**
+      Number of clocks (up to the given limit) that can pass before the
+      next pending write falls due.
+    */
+    uInt32 idleClocks(uInt32 limit) const;
+
+    /**
+      Advance the queue by the given number of clocks without executing
+      anything; all of them must be idle (see idleClocks).
+    */
+    void skip(uInt32 clocks);
+
     /**
       Serializable methods (see that class for more information).
     */
     bool save(Serializer& out) const override;
     bool load(Serializer& in) override;
+    size_t maxStateSize() const override;
 
   private:
     std::array<DelayQueueMember<capacity>, length> myMembers;
@@ -118,6 +131,26 @@ void DelayQueue<length, capacity>::execute(T executor)
   myIndex = smartmod<length>(myIndex + 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+uInt32 DelayQueue<length, capacity>::idleClocks(uInt32 limit) const
+{
+  const uInt32 slots = std::min(limit, length);
+
+  for (uInt32 i = 0; i < slots; ++i)
+    if (myMembers[smartmod<length>(myIndex + i)].mySize > 0) return i;
+
+  // An empty queue stays empty, no matter how long we wait
+  return limit;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+void DelayQueue<length, capacity>::skip(uInt32 clocks)
+{
+  myIndex = smartmod<length>(myIndex + clocks % length);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 template<unsigned length, unsigned capacity>
 bool DelayQueue<length, capacity>::save(Serializer& out) const
@@ -164,4 +197,12 @@ bool DelayQueue<length, capacity>::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+size_t DelayQueue<length, capacity>::maxStateSize() const
+{
+  // See save(), with every member filled up to its capacity
+  return sizeof(uInt32) + length * (1 + 2 * capacity) + 1 + myIndices.size();
+}
+
 #endif //  TIA_DELAY_QUEUE
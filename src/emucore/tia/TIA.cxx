@@ -63,6 +63,15 @@ enum ResxCounter: uInt8 {
 // 70, the G.I. Joe will show an artifact (hole in roof).
 static constexpr uInt8 resxLateHblankThreshold = TIAConstants::H_CYCLES - 3;
 
+// The objects in the order of the coverage of a scanline
+static constexpr std::array<uInt32, 6> coverageMasks = {
+  CollisionMask::player0, CollisionMask::player1, CollisionMask::missile0,
+  CollisionMask::missile1, CollisionMask::ball, CollisionMask::playfield
+};
+
+// Latch the collisions at the latest after this number of scanlines
+static constexpr uInt32 maxCoverageLines = 512;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::TIA(ConsoleIO& console, const ConsoleTimingProvider& timingProvider,
          Settings& settings)
@@ -133,6 +142,8 @@ void TIA::initialize()
   myPriority = Priority::normal;
   myHstate = HState::blank;
   myCollisionMask = 0;
+  myCoverageLines = 0;
+  myCoverageOpen = false;
   myLinesSinceChange = 0;
   myCollisionUpdateRequired = myCollisionUpdateScheduled = false;
   myColorLossEnabled = myColorLossActive = false;
@@ -260,7 +271,7 @@ bool TIA::save(Serializer& out) const
 
     out.putBool(myCollisionUpdateRequired);
     out.putBool(myCollisionUpdateScheduled);
-    out.putInt(myCollisionMask);
+    out.putInt(collisionMask());
 
     out.putInt(myMovementClock);
     out.putBool(myMovementInProgress);
@@ -304,6 +315,15 @@ bool TIA::save(Serializer& out) const
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t TIA::maxStateSize() const
+{
+  // Only the delay queue changes its size while running
+  const size_t size = stateSize();
+
+  return size > 0 ? size - myDelayQueue.stateSize() + myDelayQueue.maxStateSize() : 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::load(Serializer& in)
 {
@@ -336,6 +356,8 @@ bool TIA::load(Serializer& in)
     myCollisionUpdateRequired = in.getBool();
     myCollisionUpdateScheduled = in.getBool();
     myCollisionMask = in.getInt();
+    myCoverageLines = 0;
+    myCoverageOpen = false;
 
     myMovementClock = in.getInt();
     myMovementInProgress = in.getBool();
@@ -430,6 +452,8 @@ uInt8 TIA::peek(uInt16 address)
   // In some cases both D7 and D6 are used; in other cases only D7 is used
   uInt8 result = 0b0000000;
 
+  if (myLazyCollisions && (address & 0x0F) <= CXBLPF) latchCollisions();
+
   switch (address & 0x0F) {
     case CXM0P:
       result = collCXM0P() & 0b11000000;
@@ -866,6 +890,8 @@ bool TIA::poke(uInt16 address, uInt8 value)
     case CXCLR:
       flushLineCache();
       myCollisionMask = 0;
+      myCoverageLines = 0;
+      myCoverageOpen = false;
       myShadowRegisters[address] = value;
       break;
 
@@ -1360,6 +1386,8 @@ void TIA::onFrameComplete()
   myFrontBufferScanlines = scanlinesLastFrame();
 
   ++myFramesSinceLastRender;
+
+  if (myLazyCollisions) latchCollisions();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1376,8 +1404,17 @@ void TIA::onHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cycle(uInt32 colorClocks)
 {
-  for (uInt32 i = 0; i < colorClocks; ++i)
+  while (colorClocks > 0)
   {
+    const uInt32 span = idleSpan(colorClocks);
+
+    if (span > 0) {
+      skipIdleSpan(span);
+      colorClocks -= span;
+
+      continue;
+    }
+
     myDelayQueue.execute(
       [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
     );
@@ -1393,7 +1430,10 @@ void TIA::cycle(uInt32 colorClocks)
       else
         tickHframe();
 
-      if (myCollisionUpdateRequired && !myFrameManager->vblank()) updateCollision();
+      if (myCollisionUpdateRequired && !myFrameManager->vblank()) {
+        if (myLazyCollisions) recordCollision();
+        else updateCollision();
+      }
     }
 
     if (++myHctr >= TIAConstants::H_CLOCKS)
@@ -1404,9 +1444,47 @@ void TIA::cycle(uInt32 colorClocks)
     #endif
 
     ++myTimestamp;
+    --colorClocks;
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::idleSpan(uInt32 limit) const
+{
+  // A scheduled collision update has to be applied on the next clock
+  if (myCollisionUpdateScheduled) return 0;
+
+  uInt32 span = 0;
+
+  if (myLinesSinceChange >= 2)
+    // The line is cloned from the previous one, so only the counters advance
+    span = TIAConstants::H_CLOCKS - myHctr;
+  else if (myHstate == HState::blank && !myMovementInProgress &&
+           myHctr > 0 && myHctr < TIAConstants::H_BLANK_CLOCKS - 1)
+    // Nothing happens in HBLANK until the visible part of the line may start
+    span = TIAConstants::H_BLANK_CLOCKS - 1 - myHctr;
+
+  return span > 0 ? myDelayQueue.idleClocks(std::min(span, limit)) : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::skipIdleSpan(uInt32 span)
+{
+  myDelayQueue.skip(span);
+
+  myCollisionUpdateRequired = false;
+
+  myHctr += span;
+  if (myHctr >= TIAConstants::H_CLOCKS)
+    nextLine();
+
+  #ifdef SOUND_SUPPORT
+    myAudio.tick(span);
+  #endif
+
+  myTimestamp += span;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::tickMovement()
 {
@@ -1477,6 +1555,9 @@ void TIA::tickHframe()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::applyRsync()
 {
+  // The clocks of the line start over, without a new line
+  nextCoverageLine();
+
   const uInt32 x = myHctr > TIAConstants::H_BLANK_CLOCKS ? myHctr - TIAConstants::H_BLANK_CLOCKS : 0;
 
   myHctrDelta = TIAConstants::H_CLOCKS - 3 - myHctr;
@@ -1494,6 +1575,7 @@ void TIA::nextLine()
   }
 
   myHctr = 0;
+  nextCoverageLine();
 
   if (!myMovementInProgress && myLinesSinceChange < 2) ++myLinesSinceChange;
 
@@ -1543,6 +1625,83 @@ void TIA::updateCollision()
   );
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::recordCollision()
+{
+  // The playfield has no collision bits at all right after a reset, which
+  // masks all collisions
+  if (myPlayfield.collision == 0) return;
+
+  if (!myCoverageOpen) {
+    if (myCoverageLines == myCoverage.size()) myCoverage.emplace_back();
+    myCoverage[myCoverageLines] = {};
+    myCoverageOpen = true;
+  }
+
+  CoverageLine& line = myCoverage[myCoverageLines];
+  const uInt32 word = myHctr >> 6;
+  const uInt64 bit = uInt64(1) << (myHctr & 63);
+
+  // An object is on if its collision bits include its own collisions
+  line[0][word] |= (myPlayer0.collision & CollisionMask::player0) ? bit : 0;
+  line[1][word] |= (myPlayer1.collision & CollisionMask::player1) ? bit : 0;
+  line[2][word] |= (myMissile0.collision & CollisionMask::missile0) ? bit : 0;
+  line[3][word] |= (myMissile1.collision & CollisionMask::missile1) ? bit : 0;
+  line[4][word] |= (myBall.collision & CollisionMask::ball) ? bit : 0;
+  line[5][word] |= (myPlayfield.collision & CollisionMask::playfield) ? bit : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::nextCoverageLine()
+{
+  if (!myCoverageOpen) return;
+
+  myCoverageOpen = false;
+  if (++myCoverageLines >= maxCoverageLines) latchCollisions();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::latchCollisions()
+{
+  myCollisionMask = collisionMask();
+
+  myCoverageLines = 0;
+  myCoverageOpen = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::collisionMask() const
+{
+  uInt32 mask = myCollisionMask;
+
+  for (uInt32 i = 0; i < myCoverageLines + (myCoverageOpen ? 1 : 0); ++i)
+    mask |= coverageCollisions(myCoverage[i]);
+
+  return mask;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::coverageCollisions(const CoverageLine& line)
+{
+  uInt32 mask = 0;
+
+  // Two objects collide if they are on at the same clock
+  for (uInt32 i = 0; i < line.size(); ++i)
+    for (uInt32 j = i + 1; j < line.size(); ++j)
+      if ((line[i][0] & line[j][0]) | (line[i][1] & line[j][1]) |
+          (line[i][2] & line[j][2]) | (line[i][3] & line[j][3]))
+        mask |= coverageMasks[i] & coverageMasks[j];
+
+  return mask;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setLazyCollisions(bool lazy)
+{
+  latchCollisions();
+  myLazyCollisions = lazy;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::renderPixel(uInt32 x, uInt32 y)
 {
@@ -1846,8 +2005,8 @@ uInt8 TIA::resxCounter()
 uInt8 TIA::collCXM0P() const
 {
   return (
-    ((myCollisionMask & CollisionMask::missile0 & CollisionMask::player0) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::missile0 & CollisionMask::player1) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::missile0 & CollisionMask::player0) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::missile0 & CollisionMask::player1) ? 0x80 : 0)
   );
 }
 
@@ -1855,8 +2014,8 @@ uInt8 TIA::collCXM0P() const
 uInt8 TIA::collCXM1P() const
 {
   return (
-    ((myCollisionMask & CollisionMask::missile1 & CollisionMask::player1) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::missile1 & CollisionMask::player0) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::missile1 & CollisionMask::player1) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::missile1 & CollisionMask::player0) ? 0x80 : 0)
   );
 }
 
@@ -1864,8 +2023,8 @@ uInt8 TIA::collCXM1P() const
 uInt8 TIA::collCXP0FB() const
 {
   return (
-    ((myCollisionMask & CollisionMask::player0 & CollisionMask::ball) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::player0 & CollisionMask::playfield) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::player0 & CollisionMask::ball) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::player0 & CollisionMask::playfield) ? 0x80 : 0)
   );
 }
 
@@ -1873,8 +2032,8 @@ uInt8 TIA::collCXP0FB() const
 uInt8 TIA::collCXP1FB() const
 {
   return (
-    ((myCollisionMask & CollisionMask::player1 & CollisionMask::ball) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::player1 & CollisionMask::playfield) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::player1 & CollisionMask::ball) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::player1 & CollisionMask::playfield) ? 0x80 : 0)
   );
 }
 
@@ -1882,8 +2041,8 @@ uInt8 TIA::collCXP1FB() const
 uInt8 TIA::collCXM0FB() const
 {
   return (
-    ((myCollisionMask & CollisionMask::missile0 & CollisionMask::ball) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::missile0 & CollisionMask::playfield) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::missile0 & CollisionMask::ball) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::missile0 & CollisionMask::playfield) ? 0x80 : 0)
   );
 }
 
@@ -1891,8 +2050,8 @@ uInt8 TIA::collCXM0FB() const
 uInt8 TIA::collCXM1FB() const
 {
   return (
-    ((myCollisionMask & CollisionMask::missile1 & CollisionMask::ball) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::missile1 & CollisionMask::playfield) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::missile1 & CollisionMask::ball) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::missile1 & CollisionMask::playfield) ? 0x80 : 0)
   );
 }
 
@@ -1900,104 +2059,119 @@ uInt8 TIA::collCXM1FB() const
 uInt8 TIA::collCXPPMM() const
 {
   return (
-    ((myCollisionMask & CollisionMask::missile0 & CollisionMask::missile1) ? 0x40 : 0) |
-    ((myCollisionMask & CollisionMask::player0 & CollisionMask::player1) ? 0x80 : 0)
+    ((collisionMask() & CollisionMask::missile0 & CollisionMask::missile1) ? 0x40 : 0) |
+    ((collisionMask() & CollisionMask::player0 & CollisionMask::player1) ? 0x80 : 0)
   );
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXBLPF() const
 {
-  return (myCollisionMask & CollisionMask::ball & CollisionMask::playfield) ? 0x80 : 0;
+  return (collisionMask() & CollisionMask::ball & CollisionMask::playfield) ? 0x80 : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0PF()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0BL()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0M1()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::missile1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0M0()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::missile0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0P1()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::player1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1PF()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1BL()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1M1()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::missile1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1M0()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::missile0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM0PF()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::missile0 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM0BL()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::missile0 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM0M1()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::missile0 & CollisionMask::missile1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM1PF()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::missile1 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM1BL()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::missile1 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollBLPF()
 {
+  latchCollisions();
   myCollisionMask ^= (CollisionMask::ball & CollisionMask::playfield);
 }
 
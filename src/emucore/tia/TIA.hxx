@@ -18,6 +18,7 @@
 #ifndef TIA_TIA
 #define TIA_TIA
 
+#include <array>
 #include <functional>
 
 #include "bspf.hxx"
@@ -295,6 +296,17 @@ class TIA : public Device
     */
     uInt32 clocksThisLine() const { return myHctr - myHctrDelta; }
 
+    /**
+      Answers the number of color clocks the TIA lags behind the system
+      clock, i.e. the clocks the next updateEmulation() will run.
+
+      @return The number of pending color clocks
+    */
+    uInt32 clocksBehind() const {
+      return TIAConstants::CYCLE_CLOCKS * uInt32(mySystem->cycles() - myLastCycle)
+        + mySubClock;
+    }
+
     /**
       Answers the total number of scanlines the TIA generated in producing
       the current frame buffer. For partial frames, this will be the
@@ -392,6 +404,17 @@ class TIA : public Device
     bool toggleCollision(TIABit b, uInt8 mode = 2);
     bool toggleCollisions(bool toggle = true);
 
+    /**
+      Enables/disables lazy collision evaluation (e.g. for headless runs).
+      Instead of updating the collision latches on every clock, the clocks
+      at which each object is on are recorded per scanline, and the latches
+      are only computed when a collision register is read or the frame
+      ends.  The results are identical.
+
+      @param lazy  Whether to evaluate collisions lazily
+    */
+    void setLazyCollisions(bool lazy);
+
     /**
       Enables/disable/toggle/query 'fixed debug colors' mode.
 
@@ -542,6 +565,13 @@ class TIA : public Device
     */
     bool save(Serializer& out) const override;
 
+    /**
+      Get an upper bound for the size of the state written by save().
+
+      @return  The maximum size of the state, or 0 on any errors
+    */
+    size_t maxStateSize() const override;
+
     /**
       Load the current state of this device from the given Serializer.
 
@@ -611,6 +641,19 @@ class TIA : public Device
      */
     void cycle(uInt32 colorClocks);
 
+    /**
+     * Number of upcoming clocks (at most limit) during which nothing but the
+     * counters change: no delayed write falls due, no collision update is
+     * pending and either the line is served from the line cache or we are
+     * in plain HBLANK without HMOVE in progress.
+     */
+    uInt32 idleSpan(uInt32 limit) const;
+
+    /**
+     * Advance over a span of idle clocks in one go (see idleSpan).
+     */
+    void skipIdleSpan(uInt32 span);
+
     /**
      * Advance the movement logic by a single clock.
      */
@@ -631,6 +674,38 @@ class TIA : public Device
      */
     void updateCollision();
 
+    /**
+     * For each object (in the order player0, player1, missile0, missile1,
+     * ball, playfield), the clocks of a scanline at which it is on.
+     */
+    using CoverageLine = std::array<std::array<uInt64, 4>, 6>;
+
+    /**
+     * Record the coverage of the objects instead of updating the collision
+     * bitfield (lazy collision evaluation).
+     */
+    void recordCollision();
+
+    /**
+     * Finish the coverage of the current scanline.
+     */
+    void nextCoverageLine();
+
+    /**
+     * Update the collision bitfield from the recorded coverage.
+     */
+    void latchCollisions();
+
+    /**
+     * The collision bitfield, including the recorded coverage.
+     */
+    uInt32 collisionMask() const;
+
+    /**
+     * The collisions in the given coverage of a scanline.
+     */
+    static uInt32 coverageCollisions(const CoverageLine& line);
+
     /**
      * Execute a RSYNC.
      */
@@ -861,6 +936,16 @@ class TIA : public Device
      */
     uInt32 myCollisionMask{0};
 
+    /**
+     * Lazy collision evaluation: the coverage of the scanlines since the
+     * collision bitfield was last updated.  The entry after the finished
+     * lines is the current one, if it is open.
+     */
+    bool myLazyCollisions{false};
+    vector<CoverageLine> myCoverage;
+    uInt32 myCoverageLines{0};
+    bool myCoverageOpen{false};
+
     /**
      * The movement clock counts the extra ticks sent to the objects during
      * movement.
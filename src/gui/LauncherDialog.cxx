@@ -24,7 +24,7 @@
 #include "EditTextWidget.hxx"
 #include "FileListWidget.hxx"
 #include "FSNode.hxx"
-#include "MD5.hxx"
+#include "MD5Cache.hxx"
 #include "OptionsDialog.hxx"
 #include "HighScoresDialog.hxx"
 #include "HighScoresManager.hxx"
@@ -334,7 +334,7 @@ const string& LauncherDialog::selectedRomMD5()
   // Lookup MD5, and if not present, cache it
   auto iter = myMD5List.find(currentNode().getPath());
   if(iter == myMD5List.end())
-    myMD5List[currentNode().getPath()] = MD5::hash(currentNode());
+    myMD5List[currentNode().getPath()] = instance().md5Cache().hash(currentNode());
 
   return myMD5List[currentNode().getPath()];
 }
@@ -27,7 +27,7 @@
 #include "MessageBox.hxx"
 #include "OSystem.hxx"
 #include "FrameBuffer.hxx"
-#include "MD5.hxx"
+#include "MD5Cache.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
 #include "Settings.hxx"
@@ -117,6 +117,20 @@ void RomAuditDialog::auditRoms()
   files.reserve(2048);
   node.getChildren(files, FilesystemNode::ListMode::FilesOnly);
 
+  // Only ROM files are audited; remember their extensions for renaming
+  FSList romFiles;
+  StringList extensions;
+  romFiles.reserve(files.size());
+  for(const auto& file: files)
+  {
+    string extension;
+    if(file.isFile() && Bankswitch::isValidRomName(file, extension))
+    {
+      romFiles.push_back(file);
+      extensions.push_back(extension);
+    }
+  }
+
   // Create a progress dialog box to show the progress of processing
   // the ROMs, since this is usually a time-consuming operation
   ostringstream buf;
@@ -124,45 +138,42 @@ void RomAuditDialog::auditRoms()
 
   buf << "Auditing ROM files" << ELLIPSIS;
   progress.setMessage(buf.str());
-  progress.setRange(0, int(files.size()) - 1, 5);
+  progress.setRange(0, int(romFiles.size()), 5);
   progress.open();
 
+  // Calculate the MD5s (in parallel, and from the cache where possible)
+  // so we can get the rest of the info from the PropertiesSet (stella.pro)
+  const StringList& md5s = instance().md5Cache().hash(romFiles,
+    [&progress](size_t done) {
+      progress.setProgress(int(done));
+      return !progress.isCancelled();
+    });
+  progress.close();
+
   Properties props;
   uInt32 renamed = 0, notfound = 0;
-  for(uInt32 idx = 0; idx < files.size() && !progress.isCancelled(); ++idx)
+  for(uInt32 idx = 0; idx < romFiles.size() && !progress.isCancelled(); ++idx)
   {
-    string extension;
-    if(files[idx].isFile() &&
-       Bankswitch::isValidRomName(files[idx], extension))
+    bool renameSucceeded = false;
+
+    if(md5s[idx] != "" && instance().propSet().getMD5(md5s[idx], props))
     {
-      bool renameSucceeded = false;
+      const string& name = props.get(PropType::Cart_Name);
 
-      // Calculate the MD5 so we can get the rest of the info
-      // from the PropertiesSet (stella.pro)
-      const string& md5 = MD5::hash(files[idx]);
-      if(instance().propSet().getMD5(md5, props))
+      // Only rename the file if we found a valid properties entry
+      if(name != "" && name != romFiles[idx].getName())
       {
-        const string& name = props.get(PropType::Cart_Name);
-
-        // Only rename the file if we found a valid properties entry
-        if(name != "" && name != files[idx].getName())
-        {
-          string newfile = node.getPath();
-          newfile.append(name).append(".").append(extension);
-          if(files[idx].getPath() != newfile && files[idx].rename(newfile))
-            renameSucceeded = true;
-        }
+        string newfile = node.getPath();
+        newfile.append(name).append(".").append(extensions[idx]);
+        if(romFiles[idx].getPath() != newfile && romFiles[idx].rename(newfile))
+          renameSucceeded = true;
       }
-      if(renameSucceeded)
-        ++renamed;
-      else
-        ++notfound;
     }
-
-    // Update the progress bar, indicating one more ROM has been processed
-    progress.incProgress();
+    if(renameSucceeded)
+      ++renamed;
+    else
+      ++notfound;
   }
-  progress.close();
 
   myResults1->setText(std::to_string(renamed));
   myResults2->setText(std::to_string(notfound));
@@ -188,9 +188,7 @@ void StellaLIBRETRO::updateAudio()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::loadState(const void* data, size_t size)
 {
-  Serializer state;
-
-  state.putByteArray(reinterpret_cast<const uInt8*>(data), static_cast<uInt32>(size));
+  Serializer state(static_cast<const uInt8*>(data), size);
 
   if(!myOSystem->state().loadState(state))
     return false;
@@ -202,27 +200,23 @@ bool StellaLIBRETRO::loadState(const void* data, size_t size)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::saveState(void* data, size_t size) const
 {
-  Serializer state;
-
-  if (!myOSystem->state().saveState(state))
-    return false;
-
-  if (state.size() > size)
-    return false;
+  // Serialize directly into the frontend's buffer; a state which doesn't
+  // fit makes saving fail
+  Serializer state(static_cast<uInt8*>(data), size, Serializer::Mode::ReadWriteTrunc);
 
-  state.getByteArray(reinterpret_cast<uInt8*>(data), static_cast<uInt32>(state.size()));
-  return true;
+  return myOSystem->state().saveState(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t StellaLIBRETRO::getStateSize() const
 {
-  Serializer state;
-
-  if (!myOSystem->state().saveState(state))
-    return 0;
+  return myOSystem->state().stateSize();
+}
 
-  return state.size();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t StellaLIBRETRO::getMaxStateSize() const
+{
+  return myOSystem->state().maxStateSize();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
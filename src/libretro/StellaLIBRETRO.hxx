@@ -66,6 +66,7 @@ class StellaLIBRETRO
     constexpr uInt32 getRAMSize() const { return 128; }
 
     size_t getStateSize() const;
+    size_t getMaxStateSize() const;
 
     bool   getConsoleNTSC() const { return console_timing == ConsoleTiming::ntsc; }
 
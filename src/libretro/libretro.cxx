@@ -641,9 +641,9 @@ size_t retro_serialize_size()
   int runahead = -1;
   if(environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &runahead))
   {
-    // maximum state size possible
+    // run-ahead allocates once, so the state must never outgrow this
     if(runahead & 4)
-      return 0x100000;
+      return stella.getMaxStateSize();
   }
 
   return stella.getStateSize();
@@ -167,6 +167,20 @@ sub num_prop_types {
   return keys( %prop_type );
 }
 
+# Get the non-default properties of a properties set (except the md5),
+# as a list of [type, value] pairs
+sub build_prop_fields {
+  my @array = @_;
+  my @fields = ();
+  for (my $i = 1; $i < @array; $i++) {
+    if($prop_defaults[$i] ne $array[$i] && $array[$i] ne "") {
+      push(@fields, [ $i, $array[$i] ]);
+    }
+  }
+
+  return @fields;
+}
+
 # Convert a properties set into a C++ compatible string
 sub build_prop_string {
   my @array = @_;
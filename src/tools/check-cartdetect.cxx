@@ -0,0 +1,143 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2020 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+/**
+  Compares the bankswitching types detected by the current CartDetector with
+  those of an older version, and times both.  The older version is compiled
+  in a separate translation unit (see check-cartdetect.sh), which provides
+  OldCartDetector::autodetectType().
+
+  Usage: check-cartdetect <ROM file or directory> ...
+
+  Exits with 1 if any ROM is detected differently.
+*/
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "bspf.hxx"
+#include "Bankswitch.hxx"
+#include "CartDetector.hxx"
+#include "Logger.hxx"
+
+namespace OldCartDetector {
+  Bankswitch::Type autodetectType(const ByteBuffer& image, size_t size);
+}
+
+namespace {
+  // Number of detection rounds per timing
+  constexpr int ROUNDS = 5;
+
+  // Older detectors may read past the end of small images
+  constexpr size_t PADDING = 64_KB;
+
+  struct Rom {
+    string path;
+    ByteBuffer image;
+    size_t size{0};
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  void addRom(const std::filesystem::path& path, vector<Rom>& roms)
+  {
+    std::ifstream in(path, std::ios::binary);
+    const string data((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+    if(data.empty())
+      return;
+
+    Rom rom;
+    rom.path = path.string();
+    rom.size = data.size();
+    rom.image = make_unique<uInt8[]>(rom.size + PADDING);
+    std::memset(rom.image.get(), 0, rom.size + PADDING);
+    std::memcpy(rom.image.get(), data.data(), rom.size);
+    roms.push_back(std::move(rom));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  template<typename Detector>
+  double timeDetection(const vector<Rom>& roms, Detector detect)
+  {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < ROUNDS; ++i)
+      for(const auto& rom: roms)
+        detect(rom);
+
+    return std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start).count();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int ac, char* av[])
+{
+  if(ac < 2)
+  {
+    cout << av[0] << " <ROM file or directory> ..." << endl;
+    return 2;
+  }
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  vector<Rom> roms;
+  for(int i = 1; i < ac; ++i)
+  {
+    if(std::filesystem::is_directory(av[i]))
+    {
+      vector<std::filesystem::path> files;
+      for(const auto& entry: std::filesystem::recursive_directory_iterator(av[i]))
+        if(entry.is_regular_file())
+          files.push_back(entry.path());
+      std::sort(files.begin(), files.end());
+      for(const auto& file: files)
+        addRom(file, roms);
+    }
+    else
+      addRom(av[i], roms);
+  }
+
+  const auto detectOld = [](const Rom& rom) {
+    return OldCartDetector::autodetectType(rom.image, rom.size);
+  };
+  const auto detectNew = [](const Rom& rom) {
+    return CartDetector::autodetectType(rom.image, rom.size);
+  };
+
+  uInt32 differences = 0;
+  for(const auto& rom: roms)
+  {
+    const Bankswitch::Type oldType = detectOld(rom), newType = detectNew(rom);
+    if(oldType != newType)
+    {
+      ++differences;
+      cout << rom.path << ": " << Bankswitch::typeToName(oldType)
+           << " (old) != " << Bankswitch::typeToName(newType) << " (new)" << endl;
+    }
+  }
+
+  const double oldTime = timeDetection(roms, detectOld),
+               newTime = timeDetection(roms, detectNew);
+
+  cout << roms.size() << " ROMs, " << differences << " detected differently" << endl
+       << std::fixed << std::setprecision(3)
+       << "old: " << oldTime << "s, new: " << newTime << "s (" << ROUNDS
+       << " rounds)" << endl;
+
+  return differences == 0 ? 0 : 1;
+}
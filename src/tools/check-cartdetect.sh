@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Builds check-cartdetect with the CartDetector of the given (older) git
+# revision, and runs it on the given ROMs (default: test/roms/bankswitching).
+# This checks that changes to CartDetector detect the same types, and shows
+# the speed of both versions.
+#
+# Usage: check-cartdetect.sh <old git revision> [ROM file or directory ...]
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <old git revision> [ROM file or directory ...]"
+  exit 2
+fi
+
+REV=$1
+shift
+
+ROOT=$(git rev-parse --show-toplevel) || exit 2
+SRC=$ROOT/src
+CXX=${CXX:-g++}
+TMP=$(mktemp -d) || exit 2
+trap 'rm -rf "$TMP"' EXIT
+
+# The old detector is compiled in its own translation unit, renamed so that
+# it doesn't clash with the current one
+mkdir "$TMP/old"
+for f in CartDetector.cxx CartDetector.hxx; do
+  git -C "$ROOT" show "$REV:src/emucore/$f" > "$TMP/old/$f" || exit 2
+done
+cat > "$TMP/old.cxx" << EOF
+#define CartDetector OldCartDetectorImpl
+#include "$TMP/old/CartDetector.cxx"
+#undef CartDetector
+
+namespace OldCartDetector {
+  Bankswitch::Type autodetectType(const ByteBuffer& image, size_t size) {
+    return OldCartDetectorImpl::autodetectType(image, size);
+  }
+}
+EOF
+
+FLAGS="-std=c++17 -O2 -DBSPF_UNIX -I$SRC/common -I$SRC/emucore -I$SRC/unix"
+$CXX $FLAGS -o "$TMP/check-cartdetect" \
+  "$SRC/tools/check-cartdetect.cxx" "$TMP/old.cxx" \
+  "$SRC/emucore/CartDetector.cxx" "$SRC/emucore/Bankswitch.cxx" \
+  "$SRC/emucore/FSNode.cxx" "$SRC/unix/FSNodePOSIX.cxx" \
+  "$SRC/common/Logger.cxx" -lpthread || exit 2
+
+if [ $# -eq 0 ]; then
+  set -- "$ROOT/test/roms/bankswitching"
+fi
+"$TMP/check-cartdetect" "$@"
@@ -65,24 +65,136 @@ print OUTFILE "  This code is generated using the 'create_props.pl' script,\n";
 print OUTFILE "  located in the src/tools directory.  All properties changes\n";
 print OUTFILE "  should be made in stella.pro, and then this file should be\n";
 print OUTFILE "  regenerated and the application recompiled.\n";
+
+# Collect the non-default values of every entry, and store each distinct
+# value only once
+my @entries = ();
+my @strings = ();
+my %string_index = ();
+for my $key ( sort keys %propset )
+{
+  my $md5 = lc($key);
+  die "Invalid md5: $key\n" if $md5 !~ /^[0-9a-f]{32}$/;
+
+  my @fields = ();
+  for my $field ( PropSet::build_prop_fields(@{ $propset{$key} }) )
+  {
+    my ($type, $value) = @$field;
+    if (!defined $string_index{$value}) {
+      $string_index{$value} = scalar(@strings);
+      push(@strings, $value);
+    }
+    push(@fields, [ $type, $string_index{$value} ]);
+  }
+  my @words = map { hex(substr($md5, $_ * 8, 8)) } (0 .. 3);
+  push(@entries, { words => \@words, fields => \@fields });
+}
+die "Too many distinct property values\n" if @strings > 65536;
+
+# Build a minimal perfect hash over the binary md5s (see 'hash and displace'
+# in PropertiesSet::getMD5()); entries are stored in their hash slots
+my @buckets = map { [] } (1 .. $setsize);
+push(@{ $buckets[$_->{words}[0] % $setsize] }, $_) for @entries;
+
+my @displace = (0) x $setsize;
+my @slots = ();
+my @order = sort { @{ $buckets[$b] } <=> @{ $buckets[$a] } || $a <=> $b } (0 .. $setsize-1);
+for my $b ( @order )
+{
+  my @bucket = @{ $buckets[$b] };
+  last if @bucket <= 1;
+
+  for (my $d = 1; ; $d++)
+  {
+    my %used = ();
+    my $ok = 1;
+    for my $entry ( @bucket )
+    {
+      my $slot = slot($entry->{words}[1], $d);
+      if (defined $slots[$slot] || defined $used{$slot}) { $ok = 0; last; }
+      $used{$slot} = 1;
+    }
+    next if !$ok;
+
+    $displace[$b] = $d;
+    $slots[slot($_->{words}[1], $d)] = $_ for @bucket;
+    last;
+  }
+}
+# Buckets with a single entry go directly into the remaining free slots
+my $free = 0;
+for my $b ( @order )
+{
+  next if @{ $buckets[$b] } != 1;
+  $free++ while defined $slots[$free];
+  $slots[$free] = $buckets[$b][0];
+  $displace[$b] = -$free - 1;
+}
+
+print OUTFILE "\n";
+print OUTFILE "  All entries are keyed by their binary md5, and stored in the slots\n";
+print OUTFILE "  given by a minimal perfect hash of it.  Only non-default values are\n";
+print OUTFILE "  stored, as an index into the list of distinct property values.\n";
 print OUTFILE "*/\n";
 print OUTFILE "\nstatic constexpr uInt32 DEF_PROPS_SIZE = " . $setsize . ";";
+print OUTFILE "\nstatic constexpr uInt32 DEF_PROPS_STRINGS_SIZE = " . @strings . ";";
+my $numfields = 0;
+$numfields += @{ $_->{fields} } for @entries;
+print OUTFILE "\nstatic constexpr uInt32 DEF_PROPS_FIELDS_SIZE = " . $numfields . ";";
 print OUTFILE "\n\n";
-print OUTFILE "static const BSPF::array2D<const char*, DEF_PROPS_SIZE, " . $typesize . "> DefProps = {{\n";
+print OUTFILE "struct DefPropsField {\n";
+print OUTFILE "  uInt8 type;    // PropType\n";
+print OUTFILE "  uInt16 value;  // index into DefPropsStrings\n";
+print OUTFILE "};\n";
+print OUTFILE "\n";
+print OUTFILE "struct DefPropsEntry {\n";
+print OUTFILE "  std::array<uInt32, 4> md5;\n";
+print OUTFILE "  uInt16 firstField;  // index into DefPropsFields\n";
+print OUTFILE "  uInt8 numFields;\n";
+print OUTFILE "};\n";
+print OUTFILE "\n";
 
-# Walk the hash map and print each item in order of md5sum
-my $idx = 0;
-for my $key ( sort keys %propset )
+print OUTFILE "static const std::array<const char*, DEF_PROPS_STRINGS_SIZE> DefPropsStrings = {{\n";
+for (my $i = 0; $i < @strings; $i++)
 {
-  print OUTFILE PropSet::build_prop_string(@{ $propset{$key} });
+  print OUTFILE "  \"$strings[$i]\"" . ($i+1 < @strings ? "," : "") . "\n";
+}
+print OUTFILE "}};\n";
+print OUTFILE "\n";
 
-  if ($idx+1 < $setsize) {
-    print OUTFILE ",";
-  }
-  print OUTFILE "\n";
-  $idx++;
+print OUTFILE "static const std::array<DefPropsField, DEF_PROPS_FIELDS_SIZE> DefPropsFields = {{\n";
+my $first = 0;
+for (my $i = 0; $i < $setsize; $i++)
+{
+  my @fields = @{ $slots[$i]{fields} };
+  $slots[$i]{first} = $first;
+  $first += @fields;
+  next if !@fields;
+  print OUTFILE "  " . join(", ", map { "{ $_->[0], $_->[1] }" } @fields) .
+                ($first < $numfields ? "," : "") . "\n";
 }
+die "Too many property values\n" if $numfields > 65536;
+print OUTFILE "}};\n";
+print OUTFILE "\n";
 
+print OUTFILE "static const std::array<DefPropsEntry, DEF_PROPS_SIZE> DefProps = {{\n";
+for (my $i = 0; $i < $setsize; $i++)
+{
+  my $entry = $slots[$i];
+  printf OUTFILE "  { { 0x%08x, 0x%08x, 0x%08x, 0x%08x }, %d, %d }%s\n",
+                 @{ $entry->{words} }, $entry->{first}, scalar(@{ $entry->{fields} }),
+                 ($i+1 < $setsize ? "," : "");
+}
+print OUTFILE "}};\n";
+print OUTFILE "\n";
+
+print OUTFILE "static const std::array<Int32, DEF_PROPS_SIZE> DefPropsHash = {{\n";
+for (my $i = 0; $i < $setsize; $i += 16)
+{
+  my $last = $i + 15 < $setsize ? $i + 15 : $setsize - 1;
+  print OUTFILE "  " . join(", ", @displace[$i .. $last]) .
+                ($last+1 < $setsize ? "," : "") . "\n";
+}
 print OUTFILE "}};\n";
 print OUTFILE "\n";
 print OUTFILE "#endif\n";
@@ -90,6 +202,13 @@ print OUTFILE "#endif\n";
 close(OUTFILE);
 
 
+# The slot of an md5 in a bucket with the given displacement; this must
+# match PropertiesSet::getMD5()
+sub slot {
+  my ($word, $d) = @_;
+  return ((($word ^ $d) * 0x9E3779B1) & 0xFFFFFFFF) % $setsize;
+}
+
 sub usage {
   print "create_props.pl <INPUT properties file> <OUTPUT C++ header>\n";
   print "\n";
@@ -55,6 +55,26 @@ FilesystemNodePOSIX::FilesystemNodePOSIX(const string& path, bool verify)
     setFlags();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::getFileInfo(uInt64& size, uInt64& time) const
+{
+  struct stat st;
+
+  if(stat(_path.c_str(), &st) != 0)
+    return false;
+
+  // Use the full resolution of the modification time (in nanoseconds), so
+  // that a file rewritten within the same second is still detected
+#ifdef __APPLE__
+  const struct timespec& mtime = st.st_mtimespec;
+#else
+  const struct timespec& mtime = st.st_mtim;
+#endif
+  size = uInt64(st.st_size);
+  time = uInt64(mtime.tv_sec) * 1000000000 + uInt64(mtime.tv_nsec);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FilesystemNodePOSIX::setFlags()
 {
@@ -57,6 +57,20 @@ bool FilesystemNodeWINDOWS::isWritable() const
   return _access(_path.c_str(), W_OK) == 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodeWINDOWS::getFileInfo(uInt64& size, uInt64& time) const
+{
+  WIN32_FILE_ATTRIBUTE_DATA data;
+
+  if(!GetFileAttributesEx(toUnicode(_path.c_str()), GetFileExInfoStandard, &data))
+    return false;
+
+  size = (uInt64(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+  time = (uInt64(data.ftLastWriteTime.dwHighDateTime) << 32) |
+         data.ftLastWriteTime.dwLowDateTime;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FilesystemNodeWINDOWS::setFlags()
 {